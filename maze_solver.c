@@ -7,7 +7,15 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <limits.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <unistd.h>
+#endif
 
 #define MAX_SIZE 20
 #define WALL '#'
@@ -16,6 +24,14 @@
 #define END 'E'
 #define VISITED '.'
 #define SOLUTION '*'
+#define PLANNER_INF (INT_MAX / 2)
+#define DEFAULT_WALL_PERCENT 33  // Share of interior cells that become walls
+#define HPA_DEFAULT_CLUSTER_SIZE 32
+#define HPA_MAX_CLUSTER_SIZE 1024
+#define HPA_WIDE_ENTRANCE 6      // Border runs this long get a transition at each end
+#define HPA_NODE_BITS 16         // Abstract node id = cluster << HPA_NODE_BITS | local index
+#define HPA_FLAT_COMPARE_LIMIT 16000000 // Largest maze (cells) compared against a flat search
+#define BATCH_MAX_MAZE_SIZE 4096 // Largest side of a batch benchmark maze
 
 // Structure to represent a position in the maze
 typedef struct Position {
@@ -32,15 +48,187 @@ typedef struct Stack {
 
 // Structure to represent the maze
 typedef struct Maze {
-    char grid[MAX_SIZE][MAX_SIZE];
+    char** grid;          // Row pointers into cells, so grid[row][col] works
+    char* cells;          // Contiguous row-major cell storage
+    size_t capacity;      // Number of cells allocated in cells
+    int rowCapacity;      // Number of row pointers allocated in grid
     int rows;
     int cols;
     Position start;
     Position end;
     int solutionFound;
     int steps;
+    struct IncrementalPlanner* planner; // Attached D* Lite planner, NULL if none
+    struct HierarchicalPlanner* hierarchy; // Attached HPA* planner, NULL if none
 } Maze;
 
+// Structure to hold D* Lite search state between maze edits.
+// The search runs backward from the end cell, so g/rhs are distances to the
+// end and edits only repair the cells whose distance actually changed.
+typedef struct IncrementalPlanner {
+    Maze* maze;
+    int rows;
+    int cols;
+    int startCell;
+    int goalCell;
+    int* g;              // Current distance-to-goal estimate per cell
+    int* rhs;            // One-step lookahead distance per cell
+    int* keyPrimary;     // Queued key: min(g, rhs) + heuristic
+    int* keySecondary;   // Queued key tie-breaker: min(g, rhs)
+    int* heapPos;        // Index of each cell in heap, -1 if not queued
+    int* heap;           // Binary min-heap of cell indices
+    int heapSize;
+    long expansions;     // Cells expanded by the last search or repair
+    int cellCapacity;    // Cells the per-cell arrays can hold
+} IncrementalPlanner;
+
+// Structure to hold one thread's solver buffers, reused across solves
+typedef struct SolverScratch {
+    char* visited;
+    int* stack;
+    int cellCapacity;
+    IncrementalPlanner* planner;
+} SolverScratch;
+
+// Structure to hold the entrance transitions on one border between two clusters
+typedef struct HpaBorder {
+    int count;
+    int capacity;
+    int* offsets;        // Column (south border) or row (east border) of each transition
+} HpaBorder;
+
+// Structure to represent one cluster of the abstract graph
+typedef struct HpaCluster {
+    int nodeCount;
+    int nodeCapacity;
+    int sectionStart[5]; // First node from the top, bottom, left, right borders; [4] = nodeCount
+    int* nodeRow;
+    int* nodeCol;
+    int* dist;           // nodeCount x nodeCount intra-cluster distances, PLANNER_INF if none
+    int edgeCount;       // Intra-cluster edges plus one inter-cluster edge per node
+} HpaCluster;
+
+// Structure to record the abstract search state of one node
+typedef struct HpaSearchEntry {
+    long long id;
+    long long parent;    // -1 when reached directly from the start cell
+    int g;
+    int closed;
+    int stamp;           // Entry is valid only when it matches the planner's stamp
+} HpaSearchEntry;
+
+// Structure to represent an open-list entry of the abstract search
+typedef struct HpaHeapEntry {
+    int f;
+    int g;
+    long long id;
+} HpaHeapEntry;
+
+// Structure to hold an HPA* hierarchy over the maze.
+// The maze is split into square clusters; transitions on shared borders
+// become abstract nodes and intra-cluster distances become abstract edges.
+typedef struct HierarchicalPlanner {
+    Maze* maze;
+    int clusterSize;
+    int clusterRows;
+    int clusterCols;
+    HpaCluster* clusters;
+    HpaBorder* southBorders;  // Border between cluster (i, j) and (i + 1, j)
+    HpaBorder* eastBorders;   // Border between cluster (i, j) and (i, j + 1)
+    long abstractNodes;
+    long abstractEdges;
+    long expansions;          // Abstract nodes plus local cells expanded by the last query
+    
+    // Cluster-local breadth-first search scratch
+    int* localDist;
+    int* localParent;
+    int* localQueue;
+    int localRow0;
+    int localCol0;
+    int localWidth;
+    
+    // Abstract search scratch, reused between queries
+    HpaSearchEntry* table;
+    int tableCapacity;
+    int tableUsed;
+    int stamp;
+    HpaHeapEntry* open;
+    int openSize;
+    int openCapacity;
+    int* startLinks;
+    int* goalLinks;
+    int linkCapacity;
+    long long* chain;
+    int chainCapacity;
+    
+    // Refined cell path of the last query, start to goal
+    int* pathRows;
+    int* pathCols;
+    int pathCount;
+    int pathCapacity;
+} HierarchicalPlanner;
+
+// Enumeration for the available solver engines
+typedef enum {
+    ENGINE_BACKTRACKING,
+    ENGINE_DSTAR_LITE,
+    ENGINE_HPA,
+    ENGINE_COUNT
+} SolverEngine;
+
+// Structure to report the outcome of a quiet (non-printing) solve
+typedef struct SolveResult {
+    int found;
+    int pathLength;      // Moves from start to end, -1 if not found
+    long expansions;     // Cells (or abstract nodes) expanded by the search
+    double setupMs;      // Time spent allocating or building search structures
+    double solveMs;      // Time spent searching
+} SolveResult;
+
+// Function to get solver engine name string
+const char* getEngineName(SolverEngine engine) {
+    switch (engine) {
+        case ENGINE_BACKTRACKING: return "backtracking";
+        case ENGINE_DSTAR_LITE: return "dstar_lite";
+        case ENGINE_HPA: return "hpa";
+        default: return "unknown";
+    }
+}
+
+// Function to read a monotonic timestamp in milliseconds for benchmarks.
+// The wall clock can step under NTP, which would skew or negate timings.
+double currentTimeMs() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1000.0 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1000.0 + now.tv_nsec / 1000000.0;
+#endif
+}
+
+// Function to turn a seed into a non-zero random generator state
+unsigned int seedRandomState(unsigned int seed) {
+    return seed != 0 ? seed : 0x9E3779B9u;
+}
+
+// Function to get the next value from a xorshift generator.
+// Unlike rand(), the sequence is the same on every platform for a given seed.
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
 // Function to create a new position
 Position* createPosition(int row, int col) {
     Position* pos = (Position*)malloc(sizeof(Position));
@@ -88,13 +276,60 @@ Position* peek(Stack* stack) {
     return stack->top;
 }
 
+// Function to (re)size the maze grid storage
+int setMazeDimensions(Maze* maze, int rows, int cols) {
+    size_t needed = (size_t)rows * (size_t)cols;
+    
+    if (needed > maze->capacity) {
+        char* cells = (char*)realloc(maze->cells, needed);
+        if (cells == NULL) {
+            printf("Error: Not enough memory for a %dx%d maze\n", rows, cols);
+            return 0;
+        }
+        maze->cells = cells;
+        maze->capacity = needed;
+    }
+    
+    if (rows > maze->rowCapacity) {
+        char** grid = (char**)realloc(maze->grid, rows * sizeof(char*));
+        if (grid == NULL) {
+            printf("Error: Not enough memory for a %dx%d maze\n", rows, cols);
+            return 0;
+        }
+        maze->grid = grid;
+        maze->rowCapacity = rows;
+    }
+    
+    for (int i = 0; i < rows; i++) {
+        maze->grid[i] = maze->cells + (size_t)i * cols;
+    }
+    
+    maze->rows = rows;
+    maze->cols = cols;
+    return 1;
+}
+
 // Function to create a maze
 Maze* createMaze(int rows, int cols) {
     Maze* maze = (Maze*)malloc(sizeof(Maze));
-    maze->rows = rows;
-    maze->cols = cols;
+    maze->grid = NULL;
+    maze->cells = NULL;
+    maze->capacity = 0;
+    maze->rowCapacity = 0;
     maze->solutionFound = 0;
     maze->steps = 0;
+    maze->planner = NULL;
+    maze->hierarchy = NULL;
+    maze->start.row = maze->start.col = -1; // No start or end until a maze is loaded
+    maze->end.row = maze->end.col = -1;
+    
+    if (!setMazeDimensions(maze, rows, cols)) {
+        // The cells may have been allocated before the row table failed
+        free(maze->grid);
+        free(maze->cells);
+        free(maze);
+        return NULL;
+    }
     
     // Initialize with walls
     for (int i = 0; i < rows; i++) {
@@ -121,22 +356,931 @@ void displayMaze(Maze* maze) {
         for (int j = 0; j < maze->cols; j++) {
             printf(" %c", maze->grid[i][j]);
         }
-        printf("\n");
+        printf("\n");
+    }
+    printf("\n");
+}
+
+// Function to check if a position is valid
+int isValidPosition(Maze* maze, int row, int col) {
+    return (row >= 0 && row < maze->rows && 
+            col >= 0 && col < maze->cols);
+}
+
+// Function to check if a maze with a start and an end has been loaded
+int hasMazeLoaded(Maze* maze) {
+    return isValidPosition(maze, maze->start.row, maze->start.col) &&
+           isValidPosition(maze, maze->end.row, maze->end.col);
+}
+
+// Function to check if a position can be moved to
+int canMoveTo(Maze* maze, int row, int col) {
+    return (isValidPosition(maze, row, col) && 
+            (maze->grid[row][col] == PATH || 
+             maze->grid[row][col] == END));
+}
+
+// Function to check if a cell blocks movement
+int isCellBlocked(Maze* maze, int row, int col) {
+    return !isValidPosition(maze, row, col) || maze->grid[row][col] == WALL;
+}
+
+// Function to clear a previously marked solution path
+void clearSolutionMarks(Maze* maze) {
+    for (int i = 0; i < maze->rows; i++) {
+        for (int j = 0; j < maze->cols; j++) {
+            if (maze->grid[i][j] == SOLUTION) {
+                maze->grid[i][j] = PATH;
+            }
+        }
+    }
+}
+
+// Function to compute the Manhattan distance between two cells
+int plannerHeuristic(IncrementalPlanner* planner, int cellA, int cellB) {
+    int dr = cellA / planner->cols - cellB / planner->cols;
+    int dc = cellA % planner->cols - cellB % planner->cols;
+    return (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc);
+}
+
+// Function to compare the queued keys of two cells
+int plannerKeyLess(IncrementalPlanner* planner, int cellA, int cellB) {
+    if (planner->keyPrimary[cellA] != planner->keyPrimary[cellB]) {
+        return planner->keyPrimary[cellA] < planner->keyPrimary[cellB];
+    }
+    return planner->keySecondary[cellA] < planner->keySecondary[cellB];
+}
+
+// Function to swap two heap entries and keep positions in sync
+void plannerHeapSwap(IncrementalPlanner* planner, int i, int j) {
+    int cell = planner->heap[i];
+    planner->heap[i] = planner->heap[j];
+    planner->heap[j] = cell;
+    planner->heapPos[planner->heap[i]] = i;
+    planner->heapPos[planner->heap[j]] = j;
+}
+
+// Function to move a heap entry up or down until the heap is valid again
+void plannerHeapFix(IncrementalPlanner* planner, int index) {
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (!plannerKeyLess(planner, planner->heap[index], planner->heap[parent])) {
+            break;
+        }
+        plannerHeapSwap(planner, index, parent);
+        index = parent;
+    }
+    
+    while (1) {
+        int left = 2 * index + 1;
+        int right = left + 1;
+        int smallest = index;
+        
+        if (left < planner->heapSize &&
+            plannerKeyLess(planner, planner->heap[left], planner->heap[smallest])) {
+            smallest = left;
+        }
+        if (right < planner->heapSize &&
+            plannerKeyLess(planner, planner->heap[right], planner->heap[smallest])) {
+            smallest = right;
+        }
+        if (smallest == index) {
+            break;
+        }
+        plannerHeapSwap(planner, index, smallest);
+        index = smallest;
+    }
+}
+
+// Function to remove a cell from the priority queue
+void plannerHeapRemove(IncrementalPlanner* planner, int cell) {
+    int index = planner->heapPos[cell];
+    int last = planner->heapSize - 1;
+    
+    if (index != last) {
+        plannerHeapSwap(planner, index, last);
+    }
+    planner->heapSize--;
+    planner->heapPos[cell] = -1;
+    
+    if (index < planner->heapSize) {
+        plannerHeapFix(planner, index);
+    }
+}
+
+// Function to (re)queue a cell with its current key
+void plannerHeapPush(IncrementalPlanner* planner, int cell) {
+    int best = planner->g[cell] < planner->rhs[cell] ? planner->g[cell] : planner->rhs[cell];
+    
+    planner->keyPrimary[cell] = best + plannerHeuristic(planner, planner->startCell, cell);
+    planner->keySecondary[cell] = best;
+    
+    if (planner->heapPos[cell] == -1) {
+        planner->heap[planner->heapSize] = cell;
+        planner->heapPos[cell] = planner->heapSize;
+        planner->heapSize++;
+    }
+    plannerHeapFix(planner, planner->heapPos[cell]);
+}
+
+// Function to recompute a cell's lookahead value and queue membership
+void plannerUpdateCell(IncrementalPlanner* planner, int cell) {
+    int row = cell / planner->cols;
+    int col = cell % planner->cols;
+    
+    if (cell != planner->goalCell) {
+        int directions[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+        int best = PLANNER_INF;
+        
+        if (!isCellBlocked(planner->maze, row, col)) {
+            for (int i = 0; i < 4; i++) {
+                int newRow = row + directions[i][0];
+                int newCol = col + directions[i][1];
+                
+                if (!isCellBlocked(planner->maze, newRow, newCol)) {
+                    int neighbor = newRow * planner->cols + newCol;
+                    if (planner->g[neighbor] + 1 < best) {
+                        best = planner->g[neighbor] + 1;
+                    }
+                }
+            }
+        }
+        planner->rhs[cell] = best;
+    }
+    
+    if (planner->g[cell] != planner->rhs[cell]) {
+        plannerHeapPush(planner, cell);
+    } else if (planner->heapPos[cell] != -1) {
+        plannerHeapRemove(planner, cell);
+    }
+}
+
+// Function to update a cell and its four neighbors after a cost change
+void plannerUpdateAround(IncrementalPlanner* planner, int row, int col, int includeSelf) {
+    int directions[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+    
+    if (includeSelf) {
+        plannerUpdateCell(planner, row * planner->cols + col);
+    }
+    for (int i = 0; i < 4; i++) {
+        int newRow = row + directions[i][0];
+        int newCol = col + directions[i][1];
+        
+        if (isValidPosition(planner->maze, newRow, newCol)) {
+            plannerUpdateCell(planner, newRow * planner->cols + newCol);
+        }
+    }
+}
+
+// Function to run D* Lite until the start cell is locally consistent
+void plannerComputeShortestPath(IncrementalPlanner* planner) {
+    int start = planner->startCell;
+    
+    planner->expansions = 0;
+    
+    while (planner->heapSize > 0) {
+        int cell = planner->heap[0];
+        int best = planner->g[start] < planner->rhs[start] ? planner->g[start] : planner->rhs[start];
+        int startPrimary = best;
+        int oldPrimary = planner->keyPrimary[cell];
+        int oldSecondary = planner->keySecondary[cell];
+        
+        // Stop once the start is consistent and no queued key can improve it
+        if ((oldPrimary > startPrimary || (oldPrimary == startPrimary && oldSecondary >= best)) &&
+            planner->g[start] == planner->rhs[start]) {
+            break;
+        }
+        
+        planner->expansions++;
+        
+        int current = planner->g[cell] < planner->rhs[cell] ? planner->g[cell] : planner->rhs[cell];
+        int newPrimary = current + plannerHeuristic(planner, start, cell);
+        
+        if (oldPrimary < newPrimary || (oldPrimary == newPrimary && oldSecondary < current)) {
+            plannerHeapPush(planner, cell); // Key is stale, requeue
+        } else if (planner->g[cell] > planner->rhs[cell]) {
+            planner->g[cell] = planner->rhs[cell];
+            plannerHeapRemove(planner, cell);
+            plannerUpdateAround(planner, cell / planner->cols, cell % planner->cols, 0);
+        } else {
+            planner->g[cell] = PLANNER_INF;
+            plannerUpdateAround(planner, cell / planner->cols, cell % planner->cols, 1);
+        }
+    }
+}
+
+// Function to clear all search state and queue the goal again
+void plannerReset(IncrementalPlanner* planner) {
+    int cellCount = planner->rows * planner->cols;
+    
+    for (int i = 0; i < cellCount; i++) {
+        planner->g[i] = PLANNER_INF;
+        planner->rhs[i] = PLANNER_INF;
+        planner->heapPos[i] = -1;
+    }
+    planner->heapSize = 0;
+    planner->rhs[planner->goalCell] = 0;
+    plannerHeapPush(planner, planner->goalCell);
+}
+
+// Function to create an incremental planner for the maze's current layout
+IncrementalPlanner* createIncrementalPlanner(Maze* maze) {
+    int cellCount = maze->rows * maze->cols;
+    IncrementalPlanner* planner = (IncrementalPlanner*)malloc(sizeof(IncrementalPlanner));
+    
+    planner->maze = maze;
+    planner->rows = maze->rows;
+    planner->cols = maze->cols;
+    planner->startCell = maze->start.row * maze->cols + maze->start.col;
+    planner->goalCell = maze->end.row * maze->cols + maze->end.col;
+    planner->g = (int*)malloc(cellCount * sizeof(int));
+    planner->rhs = (int*)malloc(cellCount * sizeof(int));
+    planner->keyPrimary = (int*)malloc(cellCount * sizeof(int));
+    planner->keySecondary = (int*)malloc(cellCount * sizeof(int));
+    planner->heapPos = (int*)malloc(cellCount * sizeof(int));
+    planner->heap = (int*)malloc(cellCount * sizeof(int));
+    planner->expansions = 0;
+    planner->cellCapacity = cellCount;
+    
+    plannerReset(planner);
+    return planner;
+}
+
+// Function to free an incremental planner
+void freeIncrementalPlanner(IncrementalPlanner* planner) {
+    free(planner->g);
+    free(planner->rhs);
+    free(planner->keyPrimary);
+    free(planner->keySecondary);
+    free(planner->heapPos);
+    free(planner->heap);
+    free(planner);
+}
+
+// Function to point a planner at another maze, reusing its arrays when they are large enough
+IncrementalPlanner* rebindIncrementalPlanner(IncrementalPlanner* planner, Maze* maze) {
+    if (planner == NULL || planner->cellCapacity < maze->rows * maze->cols) {
+        if (planner != NULL) {
+            freeIncrementalPlanner(planner);
+        }
+        return createIncrementalPlanner(maze);
+    }
+    
+    planner->maze = maze;
+    planner->rows = maze->rows;
+    planner->cols = maze->cols;
+    planner->startCell = maze->start.row * maze->cols + maze->start.col;
+    planner->goalCell = maze->end.row * maze->cols + maze->end.col;
+    planner->expansions = 0;
+    plannerReset(planner);
+    return planner;
+}
+
+// Function to point the planner at new endpoints and clear its search state
+void plannerSetEndpoints(IncrementalPlanner* planner, int startCell, int goalCell) {
+    planner->startCell = startCell;
+    planner->goalCell = goalCell;
+    plannerReset(planner);
+}
+
+// Function to repair the plan after a single cell changed
+void plannerCellChanged(IncrementalPlanner* planner, int row, int col) {
+    plannerUpdateAround(planner, row, col, 1);
+    plannerComputeShortestPath(planner);
+}
+
+// Function to get the planned path length (-1 if the end is unreachable)
+int plannerPathLength(IncrementalPlanner* planner) {
+    int length = planner->g[planner->startCell];
+    return length >= PLANNER_INF ? -1 : length;
+}
+
+// Function to mark the planned path on the maze grid
+int plannerMarkPath(IncrementalPlanner* planner) {
+    Maze* maze = planner->maze;
+    int directions[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+    int cell = planner->startCell;
+    
+    clearSolutionMarks(maze);
+    
+    maze->solutionFound = plannerPathLength(planner) >= 0;
+    if (!maze->solutionFound) {
+        return 0;
+    }
+    
+    // Greedily follow the lowest g value from start to goal
+    while (cell != planner->goalCell) {
+        int row = cell / planner->cols;
+        int col = cell % planner->cols;
+        int next = -1;
+        
+        for (int i = 0; i < 4; i++) {
+            int newRow = row + directions[i][0];
+            int newCol = col + directions[i][1];
+            
+            if (!isCellBlocked(maze, newRow, newCol)) {
+                int neighbor = newRow * planner->cols + newCol;
+                if (next == -1 || planner->g[neighbor] < planner->g[next]) {
+                    next = neighbor;
+                }
+            }
+        }
+        
+        cell = next;
+        if (cell != planner->goalCell && maze->grid[cell / planner->cols][cell % planner->cols] != START) {
+            maze->grid[cell / planner->cols][cell % planner->cols] = SOLUTION;
+        }
+    }
+    
+    return 1;
+}
+
+// Function to add a transition to a cluster border
+void hpaBorderAdd(HpaBorder* border, int offset) {
+    if (border->count == border->capacity) {
+        border->capacity = border->capacity == 0 ? 4 : border->capacity * 2;
+        border->offsets = (int*)realloc(border->offsets, border->capacity * sizeof(int));
+    }
+    border->offsets[border->count++] = offset;
+}
+
+// Function to find the entrances on a border between two rows or two columns.
+// Each maximal run of cells open on both sides becomes one transition in the
+// middle, or two at its ends when the run is wide.
+void hpaScanBorder(HierarchicalPlanner* hpa, HpaBorder* border, int horizontal,
+                   int lineA, int lineB, int from, int to) {
+    Maze* maze = hpa->maze;
+    int runStart = -1;
+    
+    border->count = 0;
+    for (int i = from; i <= to; i++) {
+        int open = 0;
+        
+        if (i < to) {
+            open = horizontal ? (!isCellBlocked(maze, lineA, i) && !isCellBlocked(maze, lineB, i))
+                              : (!isCellBlocked(maze, i, lineA) && !isCellBlocked(maze, i, lineB));
+        }
+        
+        if (open && runStart == -1) {
+            runStart = i;
+        } else if (!open && runStart != -1) {
+            int runEnd = i - 1;
+            if (runEnd - runStart + 1 >= HPA_WIDE_ENTRANCE) {
+                hpaBorderAdd(border, runStart);
+                hpaBorderAdd(border, runEnd);
+            } else {
+                hpaBorderAdd(border, (runStart + runEnd) / 2);
+            }
+            runStart = -1;
+        }
+    }
+}
+
+// Function to rebuild the border between cluster (ci, cj) and the one below it
+void hpaBuildSouthBorder(HierarchicalPlanner* hpa, int ci, int cj) {
+    int size = hpa->clusterSize;
+    int row = (ci + 1) * size - 1;
+    int colEnd = (cj + 1) * size < hpa->maze->cols ? (cj + 1) * size : hpa->maze->cols;
+    
+    hpaScanBorder(hpa, &hpa->southBorders[ci * hpa->clusterCols + cj], 1,
+                  row, row + 1, cj * size, colEnd);
+}
+
+// Function to rebuild the border between cluster (ci, cj) and the one to its right
+void hpaBuildEastBorder(HierarchicalPlanner* hpa, int ci, int cj) {
+    int size = hpa->clusterSize;
+    int col = (cj + 1) * size - 1;
+    int rowEnd = (ci + 1) * size < hpa->maze->rows ? (ci + 1) * size : hpa->maze->rows;
+    
+    hpaScanBorder(hpa, &hpa->eastBorders[ci * hpa->clusterCols + cj], 0,
+                  col, col + 1, ci * size, rowEnd);
+}
+
+// Function to run a breadth-first search confined to one cluster.
+// Distances land in localDist; localParent points one step back toward the source.
+void hpaLocalSearch(HierarchicalPlanner* hpa, int ci, int cj, int row, int col) {
+    int size = hpa->clusterSize;
+    int row0 = ci * size, col0 = cj * size;
+    int row1 = row0 + size < hpa->maze->rows ? row0 + size : hpa->maze->rows;
+    int col1 = col0 + size < hpa->maze->cols ? col0 + size : hpa->maze->cols;
+    int width = col1 - col0;
+    int cellCount = (row1 - row0) * width;
+    int directions[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+    int head = 0, tail = 0;
+    
+    hpa->localRow0 = row0;
+    hpa->localCol0 = col0;
+    hpa->localWidth = width;
+    
+    for (int i = 0; i < cellCount; i++) {
+        hpa->localDist[i] = -1;
+    }
+    if (isCellBlocked(hpa->maze, row, col)) {
+        return;
+    }
+    
+    int source = (row - row0) * width + (col - col0);
+    hpa->localDist[source] = 0;
+    hpa->localParent[source] = -1;
+    hpa->localQueue[tail++] = source;
+    
+    while (head < tail) {
+        int current = hpa->localQueue[head++];
+        int currentRow = row0 + current / width;
+        int currentCol = col0 + current % width;
+        
+        hpa->expansions++;
+        
+        for (int i = 0; i < 4; i++) {
+            int newRow = currentRow + directions[i][0];
+            int newCol = currentCol + directions[i][1];
+            
+            if (newRow < row0 || newRow >= row1 || newCol < col0 || newCol >= col1 ||
+                isCellBlocked(hpa->maze, newRow, newCol)) {
+                continue;
+            }
+            
+            int next = (newRow - row0) * width + (newCol - col0);
+            if (hpa->localDist[next] == -1) {
+                hpa->localDist[next] = hpa->localDist[current] + 1;
+                hpa->localParent[next] = current;
+                hpa->localQueue[tail++] = next;
+            }
+        }
+    }
+}
+
+// Function to read a distance from the last local search (PLANNER_INF if unreachable)
+int hpaLocalDistance(HierarchicalPlanner* hpa, int row, int col) {
+    int d = hpa->localDist[(row - hpa->localRow0) * hpa->localWidth + (col - hpa->localCol0)];
+    return d < 0 ? PLANNER_INF : d;
+}
+
+// Function to rebuild a cluster's abstract nodes and intra-cluster distances
+void hpaBuildCluster(HierarchicalPlanner* hpa, int ci, int cj) {
+    int index = ci * hpa->clusterCols + cj;
+    HpaCluster* cluster = &hpa->clusters[index];
+    int size = hpa->clusterSize;
+    int row0 = ci * size, col0 = cj * size;
+    int row1 = row0 + size < hpa->maze->rows ? row0 + size : hpa->maze->rows;
+    int col1 = col0 + size < hpa->maze->cols ? col0 + size : hpa->maze->cols;
+    HpaBorder* sections[4];
+    int count = 0;
+    
+    sections[0] = ci > 0 ? &hpa->southBorders[index - hpa->clusterCols] : NULL;
+    sections[1] = ci < hpa->clusterRows - 1 ? &hpa->southBorders[index] : NULL;
+    sections[2] = cj > 0 ? &hpa->eastBorders[index - 1] : NULL;
+    sections[3] = cj < hpa->clusterCols - 1 ? &hpa->eastBorders[index] : NULL;
+    
+    hpa->abstractNodes -= cluster->nodeCount;
+    hpa->abstractEdges -= cluster->edgeCount;
+    
+    for (int s = 0; s < 4; s++) {
+        cluster->sectionStart[s] = count;
+        count += sections[s] != NULL ? sections[s]->count : 0;
+    }
+    cluster->sectionStart[4] = count;
+    cluster->nodeCount = count;
+    
+    if (count > cluster->nodeCapacity) {
+        cluster->nodeCapacity = count;
+        cluster->nodeRow = (int*)realloc(cluster->nodeRow, count * sizeof(int));
+        cluster->nodeCol = (int*)realloc(cluster->nodeCol, count * sizeof(int));
+        cluster->dist = (int*)realloc(cluster->dist, (size_t)count * count * sizeof(int));
+    }
+    
+    // Place each transition on this cluster's side of its border
+    for (int s = 0; s < 4; s++) {
+        if (sections[s] == NULL) {
+            continue;
+        }
+        for (int t = 0; t < sections[s]->count; t++) {
+            int node = cluster->sectionStart[s] + t;
+            int offset = sections[s]->offsets[t];
+            
+            cluster->nodeRow[node] = s == 0 ? row0 : (s == 1 ? row1 - 1 : offset);
+            cluster->nodeCol[node] = s == 2 ? col0 : (s == 3 ? col1 - 1 : offset);
+        }
+    }
+    
+    // Distances are symmetric, so one search per node fills a row and a column
+    cluster->edgeCount = count;
+    for (int i = 0; i < count; i++) {
+        cluster->dist[i * count + i] = 0;
+        if (i == count - 1) {
+            break;
+        }
+        hpaLocalSearch(hpa, ci, cj, cluster->nodeRow[i], cluster->nodeCol[i]);
+        for (int j = i + 1; j < count; j++) {
+            int d = hpaLocalDistance(hpa, cluster->nodeRow[j], cluster->nodeCol[j]);
+            cluster->dist[i * count + j] = d;
+            cluster->dist[j * count + i] = d;
+            if (d < PLANNER_INF) {
+                cluster->edgeCount += 2;
+            }
+        }
+    }
+    
+    hpa->abstractNodes += cluster->nodeCount;
+    hpa->abstractEdges += cluster->edgeCount;
+}
+
+// Function to build an HPA* hierarchy over the maze's current layout
+HierarchicalPlanner* createHierarchicalPlanner(Maze* maze, int clusterSize) {
+    HierarchicalPlanner* hpa = (HierarchicalPlanner*)calloc(1, sizeof(HierarchicalPlanner));
+    
+    hpa->maze = maze;
+    hpa->clusterSize = clusterSize;
+    hpa->clusterRows = (maze->rows + clusterSize - 1) / clusterSize;
+    hpa->clusterCols = (maze->cols + clusterSize - 1) / clusterSize;
+    
+    int clusterCount = hpa->clusterRows * hpa->clusterCols;
+    hpa->clusters = (HpaCluster*)calloc(clusterCount, sizeof(HpaCluster));
+    hpa->southBorders = (HpaBorder*)calloc(clusterCount, sizeof(HpaBorder));
+    hpa->eastBorders = (HpaBorder*)calloc(clusterCount, sizeof(HpaBorder));
+    hpa->localDist = (int*)malloc(clusterSize * clusterSize * sizeof(int));
+    hpa->localParent = (int*)malloc(clusterSize * clusterSize * sizeof(int));
+    hpa->localQueue = (int*)malloc(clusterSize * clusterSize * sizeof(int));
+    
+    for (int ci = 0; ci < hpa->clusterRows; ci++) {
+        for (int cj = 0; cj < hpa->clusterCols; cj++) {
+            if (ci < hpa->clusterRows - 1) {
+                hpaBuildSouthBorder(hpa, ci, cj);
+            }
+            if (cj < hpa->clusterCols - 1) {
+                hpaBuildEastBorder(hpa, ci, cj);
+            }
+        }
+    }
+    
+    for (int ci = 0; ci < hpa->clusterRows; ci++) {
+        for (int cj = 0; cj < hpa->clusterCols; cj++) {
+            hpaBuildCluster(hpa, ci, cj);
+        }
+    }
+    
+    return hpa;
+}
+
+// Function to free an HPA* hierarchy
+void freeHierarchicalPlanner(HierarchicalPlanner* hpa) {
+    int clusterCount = hpa->clusterRows * hpa->clusterCols;
+    
+    for (int i = 0; i < clusterCount; i++) {
+        free(hpa->clusters[i].nodeRow);
+        free(hpa->clusters[i].nodeCol);
+        free(hpa->clusters[i].dist);
+        free(hpa->southBorders[i].offsets);
+        free(hpa->eastBorders[i].offsets);
+    }
+    free(hpa->clusters);
+    free(hpa->southBorders);
+    free(hpa->eastBorders);
+    free(hpa->localDist);
+    free(hpa->localParent);
+    free(hpa->localQueue);
+    free(hpa->table);
+    free(hpa->open);
+    free(hpa->startLinks);
+    free(hpa->goalLinks);
+    free(hpa->chain);
+    free(hpa->pathRows);
+    free(hpa->pathCols);
+    free(hpa);
+}
+
+// Function to rebuild only the borders and clusters touched by a cell change
+void hpaCellChanged(HierarchicalPlanner* hpa, int row, int col) {
+    int size = hpa->clusterSize;
+    int ci = row / size, cj = col / size;
+    
+    if (row % size == 0 && ci > 0) {
+        hpaBuildSouthBorder(hpa, ci - 1, cj);
+        hpaBuildCluster(hpa, ci - 1, cj);
+    }
+    if (row % size == size - 1 && ci < hpa->clusterRows - 1) {
+        hpaBuildSouthBorder(hpa, ci, cj);
+        hpaBuildCluster(hpa, ci + 1, cj);
+    }
+    if (col % size == 0 && cj > 0) {
+        hpaBuildEastBorder(hpa, ci, cj - 1);
+        hpaBuildCluster(hpa, ci, cj - 1);
+    }
+    if (col % size == size - 1 && cj < hpa->clusterCols - 1) {
+        hpaBuildEastBorder(hpa, ci, cj);
+        hpaBuildCluster(hpa, ci, cj + 1);
+    }
+    hpaBuildCluster(hpa, ci, cj);
+}
+
+// Function to find (or create) the search entry for an abstract node
+HpaSearchEntry* hpaSearchEntry(HierarchicalPlanner* hpa, long long id) {
+    if ((hpa->tableUsed + 1) * 2 > hpa->tableCapacity) {
+        HpaSearchEntry* oldTable = hpa->table;
+        int oldCapacity = hpa->tableCapacity;
+        
+        hpa->tableCapacity = oldCapacity == 0 ? 1024 : oldCapacity * 2;
+        hpa->table = (HpaSearchEntry*)calloc(hpa->tableCapacity, sizeof(HpaSearchEntry));
+        hpa->tableUsed = 0;
+        
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldTable[i].stamp == hpa->stamp) {
+                *hpaSearchEntry(hpa, oldTable[i].id) = oldTable[i];
+            }
+        }
+        free(oldTable);
+    }
+    
+    unsigned long long hash = (unsigned long long)id * 0x9E3779B97F4A7C15ULL;
+    int slot = (int)(hash >> 20) & (hpa->tableCapacity - 1);
+    
+    while (hpa->table[slot].stamp == hpa->stamp && hpa->table[slot].id != id) {
+        slot = (slot + 1) & (hpa->tableCapacity - 1);
+    }
+    
+    if (hpa->table[slot].stamp != hpa->stamp) {
+        hpa->table[slot].stamp = hpa->stamp;
+        hpa->table[slot].id = id;
+        hpa->table[slot].g = PLANNER_INF;
+        hpa->table[slot].parent = -1;
+        hpa->table[slot].closed = 0;
+        hpa->tableUsed++;
+    }
+    return &hpa->table[slot];
+}
+
+// Function to push an entry onto the abstract open list
+void hpaOpenPush(HierarchicalPlanner* hpa, int f, int g, long long id) {
+    if (hpa->openSize == hpa->openCapacity) {
+        hpa->openCapacity = hpa->openCapacity == 0 ? 1024 : hpa->openCapacity * 2;
+        hpa->open = (HpaHeapEntry*)realloc(hpa->open, hpa->openCapacity * sizeof(HpaHeapEntry));
+    }
+    
+    int index = hpa->openSize++;
+    while (index > 0) {
+        int parent = (index - 1) / 2;
+        if (hpa->open[parent].f < f || (hpa->open[parent].f == f && hpa->open[parent].g >= g)) {
+            break;
+        }
+        hpa->open[index] = hpa->open[parent];
+        index = parent;
+    }
+    hpa->open[index].f = f;
+    hpa->open[index].g = g;
+    hpa->open[index].id = id;
+}
+
+// Function to pop the best entry from the abstract open list
+HpaHeapEntry hpaOpenPop(HierarchicalPlanner* hpa) {
+    HpaHeapEntry top = hpa->open[0];
+    HpaHeapEntry last = hpa->open[--hpa->openSize];
+    int index = 0;
+    
+    while (1) {
+        int child = 2 * index + 1;
+        if (child >= hpa->openSize) {
+            break;
+        }
+        if (child + 1 < hpa->openSize &&
+            (hpa->open[child + 1].f < hpa->open[child].f ||
+             (hpa->open[child + 1].f == hpa->open[child].f && hpa->open[child + 1].g > hpa->open[child].g))) {
+            child++;
+        }
+        if (last.f < hpa->open[child].f || (last.f == hpa->open[child].f && last.g >= hpa->open[child].g)) {
+            break;
+        }
+        hpa->open[index] = hpa->open[child];
+        index = child;
+    }
+    if (hpa->openSize > 0) {
+        hpa->open[index] = last;
+    }
+    return top;
+}
+
+// Function to relax an abstract node reached with cost g
+void hpaRelax(HierarchicalPlanner* hpa, long long id, int g, long long parent, int goalRow, int goalCol) {
+    HpaSearchEntry* entry = hpaSearchEntry(hpa, id);
+    
+    if (g < entry->g) {
+        HpaCluster* cluster = &hpa->clusters[id >> HPA_NODE_BITS];
+        int local = (int)(id & ((1 << HPA_NODE_BITS) - 1));
+        int dr = cluster->nodeRow[local] - goalRow;
+        int dc = cluster->nodeCol[local] - goalCol;
+        
+        entry->g = g;
+        entry->parent = parent;
+        hpaOpenPush(hpa, g + (dr < 0 ? -dr : dr) + (dc < 0 ? -dc : dc), g, id);
+    }
+}
+
+// Function to append a cell to the refined path
+void hpaPathAppend(HierarchicalPlanner* hpa, int row, int col) {
+    if (hpa->pathCount == hpa->pathCapacity) {
+        hpa->pathCapacity = hpa->pathCapacity == 0 ? 256 : hpa->pathCapacity * 2;
+        hpa->pathRows = (int*)realloc(hpa->pathRows, hpa->pathCapacity * sizeof(int));
+        hpa->pathCols = (int*)realloc(hpa->pathCols, hpa->pathCapacity * sizeof(int));
+    }
+    hpa->pathRows[hpa->pathCount] = row;
+    hpa->pathCols[hpa->pathCount] = col;
+    hpa->pathCount++;
+}
+
+// Function to refine one intra-cluster hop into cells.
+// Searching from the destination lets the parent links be followed forward.
+void hpaAppendLocalSegment(HierarchicalPlanner* hpa, int fromRow, int fromCol, int toRow, int toCol) {
+    int size = hpa->clusterSize;
+    
+    hpaLocalSearch(hpa, fromRow / size, fromCol / size, toRow, toCol);
+    
+    int current = (fromRow - hpa->localRow0) * hpa->localWidth + (fromCol - hpa->localCol0);
+    if (hpa->localDist[current] <= 0) {
+        return;
+    }
+    
+    for (current = hpa->localParent[current]; current != -1; current = hpa->localParent[current]) {
+        hpaPathAppend(hpa, hpa->localRow0 + current / hpa->localWidth,
+                      hpa->localCol0 + current % hpa->localWidth);
+    }
+}
+
+// Function to make sure the per-query link arrays can hold a cluster's nodes
+void hpaReserveLinks(HierarchicalPlanner* hpa, int count) {
+    if (count > hpa->linkCapacity) {
+        hpa->linkCapacity = count;
+        hpa->startLinks = (int*)realloc(hpa->startLinks, count * sizeof(int));
+        hpa->goalLinks = (int*)realloc(hpa->goalLinks, count * sizeof(int));
+    }
+}
+
+// Function to answer a path query on the abstract graph and refine it locally.
+// Returns the path length (-1 if unreachable); the cells are left in pathRows/pathCols.
+int hpaFindPath(HierarchicalPlanner* hpa, int startRow, int startCol, int goalRow, int goalCol) {
+    int size = hpa->clusterSize;
+    int startIndex = (startRow / size) * hpa->clusterCols + startCol / size;
+    int goalIndex = (goalRow / size) * hpa->clusterCols + goalCol / size;
+    HpaCluster* startCluster = &hpa->clusters[startIndex];
+    HpaCluster* goalCluster = &hpa->clusters[goalIndex];
+    int bestCost = PLANNER_INF;
+    long long bestNode = -2; // -2: no path, -1: direct path inside one cluster
+    
+    hpa->expansions = 0;
+    hpa->pathCount = 0;
+    hpa->openSize = 0;
+    hpa->tableUsed = 0;
+    hpa->stamp++;
+    
+    if (isCellBlocked(hpa->maze, startRow, startCol) || isCellBlocked(hpa->maze, goalRow, goalCol)) {
+        return -1;
+    }
+    
+    hpaReserveLinks(hpa, startCluster->nodeCount > goalCluster->nodeCount ?
+                         startCluster->nodeCount : goalCluster->nodeCount);
+    
+    // Connect the goal to its cluster's nodes
+    hpaLocalSearch(hpa, goalRow / size, goalCol / size, goalRow, goalCol);
+    for (int i = 0; i < goalCluster->nodeCount; i++) {
+        hpa->goalLinks[i] = hpaLocalDistance(hpa, goalCluster->nodeRow[i], goalCluster->nodeCol[i]);
+    }
+    if (startIndex == goalIndex) {
+        bestCost = hpaLocalDistance(hpa, startRow, startCol);
+        if (bestCost < PLANNER_INF) {
+            bestNode = -1;
+        }
+    }
+    
+    // Connect the start to its cluster's nodes and seed the open list
+    hpaLocalSearch(hpa, startRow / size, startCol / size, startRow, startCol);
+    for (int i = 0; i < startCluster->nodeCount; i++) {
+        hpa->startLinks[i] = hpaLocalDistance(hpa, startCluster->nodeRow[i], startCluster->nodeCol[i]);
+    }
+    for (int i = 0; i < startCluster->nodeCount; i++) {
+        if (hpa->startLinks[i] < PLANNER_INF) {
+            hpaRelax(hpa, ((long long)startIndex << HPA_NODE_BITS) | i, hpa->startLinks[i], -1,
+                     goalRow, goalCol);
+        }
+    }
+    
+    // A* over the abstract graph
+    while (hpa->openSize > 0) {
+        HpaHeapEntry top = hpaOpenPop(hpa);
+        if (top.f >= bestCost) {
+            break;
+        }
+        
+        HpaSearchEntry* entry = hpaSearchEntry(hpa, top.id);
+        if (entry->closed || top.g > entry->g) {
+            continue;
+        }
+        entry->closed = 1;
+        hpa->expansions++;
+        
+        int clusterIndex = (int)(top.id >> HPA_NODE_BITS);
+        int local = (int)(top.id & ((1 << HPA_NODE_BITS) - 1));
+        HpaCluster* cluster = &hpa->clusters[clusterIndex];
+        
+        if (clusterIndex == goalIndex && top.g + hpa->goalLinks[local] < bestCost) {
+            bestCost = top.g + hpa->goalLinks[local];
+            bestNode = top.id;
+        }
+        
+        // Intra-cluster edges
+        for (int j = 0; j < cluster->nodeCount; j++) {
+            int d = cluster->dist[local * cluster->nodeCount + j];
+            if (j != local && d < PLANNER_INF) {
+                hpaRelax(hpa, ((long long)clusterIndex << HPA_NODE_BITS) | j, top.g + d, top.id,
+                         goalRow, goalCol);
+            }
+        }
+        
+        // Inter-cluster edge to the matching transition on the other side
+        int section = 0;
+        while (local >= cluster->sectionStart[section + 1]) {
+            section++;
+        }
+        int offset = local - cluster->sectionStart[section];
+        int neighborIndex = section == 0 ? clusterIndex - hpa->clusterCols :
+                            section == 1 ? clusterIndex + hpa->clusterCols :
+                            section == 2 ? clusterIndex - 1 : clusterIndex + 1;
+        int neighborSection = section ^ 1; // top<->bottom, left<->right
+        int neighborLocal = hpa->clusters[neighborIndex].sectionStart[neighborSection] + offset;
+        
+        hpaRelax(hpa, ((long long)neighborIndex << HPA_NODE_BITS) | neighborLocal, top.g + 1, top.id,
+                 goalRow, goalCol);
+    }
+    
+    if (bestNode == -2) {
+        return -1;
+    }
+    
+    // Refine: walk the abstract chain back to the start, then expand each hop into cells
+    hpaPathAppend(hpa, startRow, startCol);
+    if (bestNode == -1) {
+        hpaAppendLocalSegment(hpa, startRow, startCol, goalRow, goalCol);
+        return bestCost;
+    }
+    
+    int chainLength = 0;
+    for (long long id = bestNode; id != -1; id = hpaSearchEntry(hpa, id)->parent) {
+        if (chainLength == hpa->chainCapacity) {
+            hpa->chainCapacity = hpa->chainCapacity == 0 ? 64 : hpa->chainCapacity * 2;
+            hpa->chain = (long long*)realloc(hpa->chain, hpa->chainCapacity * sizeof(long long));
+        }
+        hpa->chain[chainLength++] = id;
+    }
+    
+    int row = startRow, col = startCol;
+    for (int i = chainLength - 1; i >= 0; i--) {
+        HpaCluster* cluster = &hpa->clusters[hpa->chain[i] >> HPA_NODE_BITS];
+        int local = (int)(hpa->chain[i] & ((1 << HPA_NODE_BITS) - 1));
+        int nextRow = cluster->nodeRow[local];
+        int nextCol = cluster->nodeCol[local];
+        
+        if (row / size == nextRow / size && col / size == nextCol / size) {
+            hpaAppendLocalSegment(hpa, row, col, nextRow, nextCol);
+        } else {
+            hpaPathAppend(hpa, nextRow, nextCol); // Step across the border
+        }
+        row = nextRow;
+        col = nextCol;
+    }
+    hpaAppendLocalSegment(hpa, row, col, goalRow, goalCol);
+    
+    return bestCost;
+}
+
+// Function to mark the last HPA* path on the maze grid
+void hpaMarkPath(HierarchicalPlanner* hpa) {
+    Maze* maze = hpa->maze;
+    
+    clearSolutionMarks(maze);
+    for (int i = 0; i < hpa->pathCount; i++) {
+        char* cell = &maze->grid[hpa->pathRows[i]][hpa->pathCols[i]];
+        if (*cell != START && *cell != END) {
+            *cell = SOLUTION;
+        }
     }
-    printf("\n");
+    maze->solutionFound = hpa->pathCount > 0;
 }
 
-// Function to check if a position is valid
-int isValidPosition(Maze* maze, int row, int col) {
-    return (row >= 0 && row < maze->rows && 
-            col >= 0 && col < maze->cols);
+// Function to drop the planners attached to a maze (layout or endpoints changed)
+void detachPlanner(Maze* maze) {
+    if (maze->planner != NULL) {
+        freeIncrementalPlanner(maze->planner);
+        maze->planner = NULL;
+    }
+    if (maze->hierarchy != NULL) {
+        freeHierarchicalPlanner(maze->hierarchy);
+        maze->hierarchy = NULL;
+    }
 }
 
-// Function to check if a position can be moved to
-int canMoveTo(Maze* maze, int row, int col) {
-    return (isValidPosition(maze, row, col) && 
-            (maze->grid[row][col] == PATH || 
-             maze->grid[row][col] == END));
+// Function to free a maze and its attached planners
+void freeMaze(Maze* maze) {
+    detachPlanner(maze);
+    free(maze->grid);
+    free(maze->cells);
+    free(maze);
 }
 
 // Function to load a predefined maze
@@ -154,8 +1298,8 @@ void loadSampleMaze(Maze* maze) {
         "#   #           #  E#"
     };
     
-    maze->rows = 10;
-    maze->cols = 20;
+    detachPlanner(maze);
+    setMazeDimensions(maze, 10, 20);
     
     for (int i = 0; i < maze->rows; i++) {
         for (int j = 0; j < maze->cols; j++) {
@@ -176,12 +1320,12 @@ void loadSampleMaze(Maze* maze) {
            maze->end.row, maze->end.col);
 }
 
-// Function to generate a random maze
-void generateRandomMaze(Maze* maze, int rows, int cols) {
-    maze->rows = rows;
-    maze->cols = cols;
-    
-    srand(time(NULL));
+// Function to fill the maze with random walls without printing anything
+int fillRandomMaze(Maze* maze, int rows, int cols, int wallPercent, unsigned int* rngState) {
+    detachPlanner(maze);
+    if (!setMazeDimensions(maze, rows, cols)) {
+        return 0;
+    }
     
     // Fill with random walls and paths
     for (int i = 0; i < rows; i++) {
@@ -189,7 +1333,7 @@ void generateRandomMaze(Maze* maze, int rows, int cols) {
             if (i == 0 || i == rows-1 || j == 0 || j == cols-1) {
                 maze->grid[i][j] = WALL; // Border walls
             } else {
-                maze->grid[i][j] = (rand() % 3 == 0) ? WALL : PATH;
+                maze->grid[i][j] = ((int)(nextRandom(rngState) % 100) < wallPercent) ? WALL : PATH;
             }
         }
     }
@@ -211,7 +1355,16 @@ void generateRandomMaze(Maze* maze, int rows, int cols) {
     maze->grid[rows-2][cols-3] = PATH;
     maze->grid[rows-3][cols-2] = PATH;
     
-    printf("Random maze generated!\n");
+    return 1;
+}
+
+// Function to generate a random maze
+void generateRandomMaze(Maze* maze, int rows, int cols) {
+    unsigned int rngState = seedRandomState((unsigned int)time(NULL));
+    
+    if (fillRandomMaze(maze, rows, cols, DEFAULT_WALL_PERCENT, &rngState)) {
+        printf("Random maze generated!\n");
+    }
 }
 
 // Function to solve maze using backtracking with stack
@@ -287,10 +1440,8 @@ int solveMaze(Maze* maze) {
             Position* deadEnd = pop(pathStack);
             printf("  Dead end! Backtracking from (%d, %d)\n", deadEnd->row, deadEnd->col);
             
-            if (maze->grid[deadEnd->row][deadEnd->col] != START) {
-                maze->grid[deadEnd->row][deadEnd->col] = PATH; // Unmark visited
-            }
-            
+            // Leave the cell marked visited; unmarking it lets the previous
+            // cell step straight back into the same dead end forever
             free(deadEnd);
             
             if (!isStackEmpty(pathStack)) {
@@ -310,6 +1461,362 @@ int solveMaze(Maze* maze) {
     return 0;
 }
 
+// Function to prepare empty solver scratch buffers
+void initSolverScratch(SolverScratch* scratch) {
+    scratch->visited = NULL;
+    scratch->stack = NULL;
+    scratch->cellCapacity = 0;
+    scratch->planner = NULL;
+}
+
+// Function to free solver scratch buffers
+void freeSolverScratch(SolverScratch* scratch) {
+    free(scratch->visited);
+    free(scratch->stack);
+    if (scratch->planner != NULL) {
+        freeIncrementalPlanner(scratch->planner);
+    }
+    initSolverScratch(scratch);
+}
+
+// Function to grow the backtracking buffers to fit a maze
+void reserveSolverScratch(SolverScratch* scratch, int cellCount) {
+    if (cellCount > scratch->cellCapacity) {
+        free(scratch->visited);
+        free(scratch->stack);
+        scratch->visited = (char*)malloc(cellCount);
+        scratch->stack = (int*)malloc(cellCount * sizeof(int));
+        scratch->cellCapacity = cellCount;
+    }
+}
+
+// Function to solve the maze with stack-based backtracking without printing
+// or touching the grid. Visited cells are tracked in the scratch buffers.
+SolveResult solveBacktrackingQuiet(Maze* maze, SolverScratch* scratch) {
+    SolveResult result = {0, -1, 0, 0.0, 0.0};
+    int directions[4][2] = {{-1, 0}, {0, 1}, {1, 0}, {0, -1}};
+    int cellCount = maze->rows * maze->cols;
+    int goal = maze->end.row * maze->cols + maze->end.col;
+    
+    double begin = currentTimeMs();
+    reserveSolverScratch(scratch, cellCount);
+    memset(scratch->visited, 0, cellCount);
+    char* visited = scratch->visited;
+    int* stack = scratch->stack;
+    int top = 0;
+    result.setupMs = currentTimeMs() - begin;
+    
+    begin = currentTimeMs();
+    if (!isCellBlocked(maze, maze->start.row, maze->start.col)) {
+        stack[top++] = maze->start.row * maze->cols + maze->start.col;
+        visited[stack[0]] = 1;
+    }
+    
+    while (top > 0) {
+        int current = stack[top - 1];
+        int row = current / maze->cols;
+        int col = current % maze->cols;
+        int moved = 0;
+        
+        result.expansions++;
+        
+        if (current == goal) {
+            result.found = 1;
+            result.pathLength = top - 1;
+            break;
+        }
+        
+        for (int i = 0; i < 4; i++) {
+            int newRow = row + directions[i][0];
+            int newCol = col + directions[i][1];
+            
+            if (!isCellBlocked(maze, newRow, newCol) && !visited[newRow * maze->cols + newCol]) {
+                visited[newRow * maze->cols + newCol] = 1;
+                stack[top++] = newRow * maze->cols + newCol;
+                moved = 1;
+                break;
+            }
+        }
+        
+        if (!moved) {
+            top--; // Dead end - backtrack
+        }
+    }
+    result.solveMs = currentTimeMs() - begin;
+    
+    return result;
+}
+
+// Function to solve a maze with the chosen engine using caller-owned scratch buffers.
+// Nothing global is touched and the maze is only read, so different threads may
+// solve different (or the same) mazes concurrently with their own scratch.
+SolveResult solveMazeWithScratch(Maze* maze, SolverEngine engine, int clusterSize, SolverScratch* scratch) {
+    SolveResult result = {0, -1, 0, 0.0, 0.0};
+    double begin;
+    
+    switch (engine) {
+        case ENGINE_BACKTRACKING:
+            return solveBacktrackingQuiet(maze, scratch);
+            
+        case ENGINE_DSTAR_LITE: {
+            begin = currentTimeMs();
+            scratch->planner = rebindIncrementalPlanner(scratch->planner, maze);
+            result.setupMs = currentTimeMs() - begin;
+            
+            begin = currentTimeMs();
+            plannerComputeShortestPath(scratch->planner);
+            result.solveMs = currentTimeMs() - begin;
+            
+            result.pathLength = plannerPathLength(scratch->planner);
+            result.found = result.pathLength >= 0;
+            result.expansions = scratch->planner->expansions;
+            break;
+        }
+            
+        case ENGINE_HPA: {
+            begin = currentTimeMs();
+            HierarchicalPlanner* hpa = createHierarchicalPlanner(maze, clusterSize);
+            result.setupMs = currentTimeMs() - begin;
+            
+            begin = currentTimeMs();
+            result.pathLength = hpaFindPath(hpa, maze->start.row, maze->start.col,
+                                            maze->end.row, maze->end.col);
+            result.solveMs = currentTimeMs() - begin;
+            
+            result.found = result.pathLength >= 0;
+            result.expansions = hpa->expansions;
+            freeHierarchicalPlanner(hpa);
+            break;
+        }
+            
+        default:
+            break;
+    }
+    
+    return result;
+}
+
+// Function to solve the maze with the chosen engine without printing anything.
+// The maze grid is left untouched, so the same maze can be solved repeatedly.
+SolveResult solveMazeQuiet(Maze* maze, SolverEngine engine, int clusterSize) {
+    SolverScratch scratch;
+    
+    initSolverScratch(&scratch);
+    SolveResult result = solveMazeWithScratch(maze, engine, clusterSize, &scratch);
+    freeSolverScratch(&scratch);
+    return result;
+}
+
+// Structure to describe one maze of a batch solve
+typedef struct MazeQuery {
+    Maze* maze;              // Only read during the batch
+    SolverEngine engine;
+    int clusterSize;         // Used by ENGINE_HPA
+} MazeQuery;
+
+// Structure shared by the worker threads of one batch
+typedef struct BatchJob {
+    MazeQuery* queries;
+    SolveResult* results;
+    int count;
+    atomic_int nextQuery;    // Next unclaimed query index
+} BatchJob;
+
+// Function to get the number of online processors
+int detectCpuCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Function run by each batch worker: claim queries until none are left
+void* batchWorker(void* arg) {
+    BatchJob* job = (BatchJob*)arg;
+    SolverScratch scratch;
+    
+    initSolverScratch(&scratch);
+    while (1) {
+        int index = atomic_fetch_add(&job->nextQuery, 1);
+        if (index >= job->count) {
+            break;
+        }
+        
+        MazeQuery* query = &job->queries[index];
+        job->results[index] = solveMazeWithScratch(query->maze, query->engine, query->clusterSize, &scratch);
+    }
+    freeSolverScratch(&scratch);
+    return NULL;
+}
+
+// Function to solve a batch of independent mazes on a pool of worker threads.
+// results[i] receives the outcome of queries[i]. Returns the number of threads used.
+int solveMazeBatch(MazeQuery* queries, SolveResult* results, int count, int threadCount) {
+    BatchJob job;
+    
+    job.queries = queries;
+    job.results = results;
+    job.count = count;
+    atomic_init(&job.nextQuery, 0);
+    
+    if (threadCount > count) {
+        threadCount = count;
+    }
+    if (threadCount <= 1) {
+        batchWorker(&job);
+        return 1;
+    }
+    
+    pthread_t* threads = (pthread_t*)malloc(threadCount * sizeof(pthread_t));
+    int started = 0;
+    
+    for (int i = 0; i < threadCount; i++) {
+        if (pthread_create(&threads[i], NULL, batchWorker, &job) != 0) {
+            break; // Remaining queries are picked up by the threads already running
+        }
+        started++;
+    }
+    if (started == 0) {
+        batchWorker(&job);
+        started = 1;
+    } else {
+        for (int i = 0; i < started; i++) {
+            pthread_join(threads[i], NULL);
+        }
+    }
+    
+    free(threads);
+    return started;
+}
+
+// Function to benchmark batch throughput for increasing worker counts
+void benchmarkBatchSolving(int mazeCount, int size, int wallPercent, SolverEngine engine,
+                           int maxThreads, unsigned int seed) {
+    Maze** mazes = (Maze**)malloc(mazeCount * sizeof(Maze*));
+    MazeQuery* queries = (MazeQuery*)malloc(mazeCount * sizeof(MazeQuery));
+    SolveResult* reference = (SolveResult*)malloc(mazeCount * sizeof(SolveResult));
+    SolveResult* results = (SolveResult*)malloc(mazeCount * sizeof(SolveResult));
+    double singleMs = 0;
+    
+    if (mazes == NULL || queries == NULL || reference == NULL || results == NULL) {
+        printf("Error: Not enough memory for a batch of %d mazes\n", mazeCount);
+        free(mazes);
+        free(queries);
+        free(reference);
+        free(results);
+        return;
+    }
+    
+    for (int i = 0; i < mazeCount; i++) {
+        unsigned int rngState = seedRandomState(seed + (unsigned int)i);
+        mazes[i] = createMaze(size, size);
+        if (mazes[i] == NULL) {
+            while (i > 0) {
+                freeMaze(mazes[--i]);
+            }
+            free(mazes);
+            free(queries);
+            free(reference);
+            free(results);
+            return;
+        }
+        fillRandomMaze(mazes[i], size, size, wallPercent, &rngState);
+        queries[i].maze = mazes[i];
+        queries[i].engine = engine;
+        queries[i].clusterSize = HPA_DEFAULT_CLUSTER_SIZE;
+    }
+    
+    printf("\n=== BATCH SOLVING BENCHMARK ===\n");
+    printf("%d mazes of %dx%d, %d%% walls, engine %s, seed %u, %d CPUs detected\n",
+           mazeCount, size, size, wallPercent, getEngineName(engine), seed, detectCpuCount());
+    printf("%-8s %12s %14s %10s %12s\n", "Threads", "Time (ms)", "Mazes/sec", "Speedup", "Mismatches");
+    
+    // Double the worker count each round, finishing exactly at maxThreads
+    for (int threads = 1; ; threads = threads * 2 > maxThreads ? maxThreads : threads * 2) {
+        double begin = currentTimeMs();
+        solveMazeBatch(queries, threads == 1 ? reference : results, mazeCount, threads);
+        double elapsed = currentTimeMs() - begin;
+        int mismatches = 0;
+        
+        if (threads == 1) {
+            singleMs = elapsed;
+        } else {
+            for (int i = 0; i < mazeCount; i++) {
+                if (results[i].pathLength != reference[i].pathLength) {
+                    mismatches++;
+                }
+            }
+        }
+        
+        printf("%-8d %12.2f %14.1f %9.2fx %12d\n", threads, elapsed,
+               elapsed > 0 ? mazeCount * 1000.0 / elapsed : 0.0,
+               elapsed > 0 ? singleMs / elapsed : 0.0, mismatches);
+        
+        if (threads >= maxThreads) {
+            break;
+        }
+    }
+    printf("===============================\n");
+    
+    for (int i = 0; i < mazeCount; i++) {
+        freeMaze(mazes[i]);
+    }
+    free(mazes);
+    free(queries);
+    free(reference);
+    free(results);
+}
+
+// Function to print a quiet solve result
+void displaySolveResult(SolverEngine engine, SolveResult* result) {
+    printf("\n=== QUIET SOLVE RESULT (%s) ===\n", getEngineName(engine));
+    if (result->found) {
+        printf("Path length: %d steps\n", result->pathLength);
+    } else {
+        printf("No path from start to end\n");
+    }
+    printf("Expansions: %ld\n", result->expansions);
+    printf("Setup time: %.3f ms\n", result->setupMs);
+    printf("Solve time: %.3f ms\n", result->solveMs);
+    printf("================================\n");
+}
+
+// Function to run the solver benchmark sweep and write one CSV row per solve.
+// Every maze is generated from its own seed, so runs are reproducible.
+void runSolverBenchmark(FILE* out, int seedCount) {
+    int sizes[] = {64, 128, 256, 512, 1024};
+    int wallPercents[] = {10, 20, 30, 40};
+    int sizeCount = sizeof(sizes) / sizeof(sizes[0]);
+    int densityCount = sizeof(wallPercents) / sizeof(wallPercents[0]);
+    Maze* maze = createMaze(4, 4);
+    
+    fprintf(out, "engine,rows,cols,wall_percent,seed,found,path_length,expansions,setup_ms,solve_ms\n");
+    
+    for (int s = 0; s < sizeCount; s++) {
+        for (int d = 0; d < densityCount; d++) {
+            for (int seed = 1; seed <= seedCount; seed++) {
+                unsigned int rngState = seedRandomState((unsigned int)seed);
+                fillRandomMaze(maze, sizes[s], sizes[s], wallPercents[d], &rngState);
+                
+                for (int engine = 0; engine < ENGINE_COUNT; engine++) {
+                    SolveResult result = solveMazeQuiet(maze, (SolverEngine)engine, HPA_DEFAULT_CLUSTER_SIZE);
+                    fprintf(out, "%s,%d,%d,%d,%d,%d,%d,%ld,%.4f,%.4f\n",
+                            getEngineName((SolverEngine)engine), sizes[s], sizes[s], wallPercents[d], seed,
+                            result.found, result.pathLength, result.expansions,
+                            result.setupMs, result.solveMs);
+                }
+                fflush(out);
+            }
+        }
+    }
+    
+    freeMaze(maze);
+}
+
 // Function to display solution path
 void displaySolutionPath(Maze* maze) {
     if (!maze->solutionFound) {
@@ -375,11 +1882,252 @@ void editMaze(Maze* maze) {
     if (cell == WALL || cell == PATH) {
         maze->grid[row][col] = cell;
         printf("Cell (%d, %d) updated!\n", row, col);
+        
+        // Repair the incremental plan instead of re-solving from scratch
+        if (maze->planner != NULL) {
+            plannerCellChanged(maze->planner, row, col);
+            if (plannerMarkPath(maze->planner)) {
+                printf("Path repaired: length %d (%ld cells re-expanded)\n",
+                       plannerPathLength(maze->planner), maze->planner->expansions);
+            } else {
+                printf("Path repaired: end is no longer reachable (%ld cells re-expanded)\n",
+                       maze->planner->expansions);
+            }
+        }
+        
+        // Rebuild only the clusters that contain or border the edited cell
+        if (maze->hierarchy != NULL) {
+            HierarchicalPlanner* hpa = maze->hierarchy;
+            double begin = currentTimeMs();
+            
+            hpaCellChanged(hpa, row, col);
+            printf("Hierarchy rebuilt incrementally in %.3f ms\n", currentTimeMs() - begin);
+            
+            int length = hpaFindPath(hpa, maze->start.row, maze->start.col, maze->end.row, maze->end.col);
+            if (length >= 0) {
+                hpaMarkPath(hpa);
+                printf("Hierarchical path length: %d\n", length);
+            } else {
+                clearSolutionMarks(maze);
+                maze->solutionFound = 0;
+                printf("Hierarchical planner: end is no longer reachable\n");
+            }
+        }
     } else {
         printf("Invalid cell value!\n");
     }
 }
 
+// Function to plan a path with D* Lite and keep the planner for later edits
+void planMazeIncrementally(Maze* maze) {
+    if (maze->planner == NULL) {
+        maze->planner = createIncrementalPlanner(maze);
+        plannerComputeShortestPath(maze->planner);
+        printf("Incremental planner created (%ld cells expanded)\n", maze->planner->expansions);
+    } else {
+        printf("Incremental planner already up to date\n");
+    }
+    
+    if (plannerMarkPath(maze->planner)) {
+        printf("Shortest path length: %d steps\n", plannerPathLength(maze->planner));
+        printf("Edits made from the menu will now repair this path incrementally.\n");
+        displayMaze(maze);
+    } else {
+        printf("No path from start to end!\n");
+    }
+}
+
+// Function to plan a path with HPA* and keep the hierarchy for later edits
+void planMazeHierarchically(Maze* maze, int clusterSize) {
+    detachPlanner(maze);
+    
+    double begin = currentTimeMs();
+    maze->hierarchy = createHierarchicalPlanner(maze, clusterSize);
+    double buildMs = currentTimeMs() - begin;
+    
+    HierarchicalPlanner* hpa = maze->hierarchy;
+    printf("Hierarchy built in %.3f ms: %dx%d clusters, %ld abstract nodes, %ld abstract edges\n",
+           buildMs, hpa->clusterRows, hpa->clusterCols, hpa->abstractNodes, hpa->abstractEdges);
+    
+    int length = hpaFindPath(hpa, maze->start.row, maze->start.col, maze->end.row, maze->end.col);
+    if (length >= 0) {
+        hpaMarkPath(hpa);
+        printf("Hierarchical path length: %d steps (%ld nodes/cells expanded)\n", length, hpa->expansions);
+        printf("Edits made from the menu will now rebuild only the affected clusters.\n");
+        displayMaze(maze);
+    } else {
+        printf("No path from start to end!\n");
+    }
+}
+
+// Function to pick a random open cell of the maze
+void pickRandomOpenCell(Maze* maze, int* row, int* col, unsigned int* rngState) {
+    do {
+        *row = nextRandom(rngState) % maze->rows;
+        *col = nextRandom(rngState) % maze->cols;
+    } while (maze->grid[*row][*col] == WALL);
+}
+
+// Function to benchmark HPA* queries and incremental rebuilds on a large maze
+void benchmarkHierarchicalPlanner(int rows, int cols, int clusterSize, int queries, int edits,
+                                  unsigned int seed) {
+    Maze* maze = createMaze(rows, cols);
+    if (maze == NULL) {
+        return;
+    }
+    
+    unsigned int rngState = seedRandomState(seed);
+    fillRandomMaze(maze, rows, cols, DEFAULT_WALL_PERCENT, &rngState);
+    
+    double begin = currentTimeMs();
+    HierarchicalPlanner* hpa = createHierarchicalPlanner(maze, clusterSize);
+    double buildMs = currentTimeMs() - begin;
+    
+    // The flat comparison needs per-cell search state, so skip it on huge mazes
+    int compareFlat = (size_t)rows * cols <= HPA_FLAT_COMPARE_LIMIT;
+    IncrementalPlanner* flat = compareFlat ? createIncrementalPlanner(maze) : NULL;
+    
+    double hpaMs = 0, flatMs = 0;
+    long hpaExpansions = 0, flatExpansions = 0;
+    int reachable = 0, mismatches = 0;
+    double extraLength = 0;
+    
+    for (int i = 0; i < queries; i++) {
+        int startRow, startCol, goalRow, goalCol;
+        pickRandomOpenCell(maze, &startRow, &startCol, &rngState);
+        pickRandomOpenCell(maze, &goalRow, &goalCol, &rngState);
+        
+        begin = currentTimeMs();
+        int length = hpaFindPath(hpa, startRow, startCol, goalRow, goalCol);
+        hpaMs += currentTimeMs() - begin;
+        hpaExpansions += hpa->expansions;
+        
+        if (length >= 0) {
+            reachable++;
+        }
+        
+        if (flat != NULL) {
+            begin = currentTimeMs();
+            plannerSetEndpoints(flat, startRow * cols + startCol, goalRow * cols + goalCol);
+            plannerComputeShortestPath(flat);
+            flatMs += currentTimeMs() - begin;
+            flatExpansions += flat->expansions;
+            
+            int optimal = plannerPathLength(flat);
+            if ((optimal < 0) != (length < 0)) {
+                mismatches++;
+            } else if (optimal > 0) {
+                extraLength += (double)(length - optimal) / optimal;
+            }
+        }
+    }
+    
+    double rebuildMs = 0;
+    for (int i = 0; i < edits; i++) {
+        int row = nextRandom(&rngState) % rows;
+        int col = nextRandom(&rngState) % cols;
+        
+        maze->grid[row][col] = (maze->grid[row][col] == WALL) ? PATH : WALL;
+        begin = currentTimeMs();
+        hpaCellChanged(hpa, row, col);
+        rebuildMs += currentTimeMs() - begin;
+    }
+    
+    printf("\n=== HIERARCHICAL PLANNER BENCHMARK ===\n");
+    printf("Maze: %dx%d, cluster size %d, seed %u\n", rows, cols, clusterSize, seed);
+    printf("Abstract graph: %dx%d clusters, %ld nodes, %ld edges\n",
+           hpa->clusterRows, hpa->clusterCols, hpa->abstractNodes, hpa->abstractEdges);
+    printf("Full build: %.3f ms\n", buildMs);
+    printf("%-18s %14s %18s\n", "Method", "Avg query (ms)", "Avg expansions");
+    printf("%-18s %14.4f %18.1f\n", "HPA*", hpaMs / queries,
+           (double)hpaExpansions / queries);
+    if (flat != NULL) {
+        printf("%-18s %14.4f %18.1f\n", "Flat search", flatMs / queries,
+               (double)flatExpansions / queries);
+        printf("Average extra path length vs optimal: %.2f%%\n",
+               reachable > 0 ? extraLength / reachable * 100 : 0.0);
+        printf("Reachability mismatches: %d\n", mismatches);
+    } else {
+        printf("Flat search skipped (maze larger than %d cells)\n", HPA_FLAT_COMPARE_LIMIT);
+    }
+    printf("Reachable queries: %d of %d\n", reachable, queries);
+    if (edits > 0) {
+        printf("Incremental rebuild: %.4f ms per edit\n", rebuildMs / edits);
+    }
+    printf("======================================\n");
+    
+    if (flat != NULL) {
+        freeIncrementalPlanner(flat);
+    }
+    freeHierarchicalPlanner(hpa);
+    freeMaze(maze);
+}
+
+// Function to benchmark incremental repair against a full re-solve
+void benchmarkIncrementalPlanner(int rows, int cols, int edits, unsigned int seed) {
+    Maze* maze = createMaze(rows, cols);
+    if (maze == NULL) {
+        return;
+    }
+    
+    unsigned int rngState = seedRandomState(seed);
+    fillRandomMaze(maze, rows, cols, DEFAULT_WALL_PERCENT, &rngState);
+    
+    IncrementalPlanner* incremental = createIncrementalPlanner(maze);
+    IncrementalPlanner* fresh = createIncrementalPlanner(maze);
+    plannerComputeShortestPath(incremental);
+    
+    double repairMs = 0, fullMs = 0;
+    long repairExpansions = 0, fullExpansions = 0;
+    int mismatches = 0;
+    
+    for (int i = 0; i < edits; i++) {
+        int row, col;
+        
+        // Pick an interior cell that is not the start or end
+        do {
+            row = 1 + nextRandom(&rngState) % (rows - 2);
+            col = 1 + nextRandom(&rngState) % (cols - 2);
+        } while ((row == maze->start.row && col == maze->start.col) ||
+                 (row == maze->end.row && col == maze->end.col));
+        
+        maze->grid[row][col] = (maze->grid[row][col] == WALL) ? PATH : WALL;
+        
+        double begin = currentTimeMs();
+        plannerCellChanged(incremental, row, col);
+        repairMs += currentTimeMs() - begin;
+        repairExpansions += incremental->expansions;
+        
+        begin = currentTimeMs();
+        plannerReset(fresh);
+        plannerComputeShortestPath(fresh);
+        fullMs += currentTimeMs() - begin;
+        fullExpansions += fresh->expansions;
+        
+        if (plannerPathLength(incremental) != plannerPathLength(fresh)) {
+            mismatches++;
+        }
+    }
+    
+    repairMs /= edits;
+    fullMs /= edits;
+    
+    printf("\n=== INCREMENTAL REPAIR BENCHMARK ===\n");
+    printf("Maze: %dx%d, %d random single-cell edits, seed %u\n", rows, cols, edits, seed);
+    printf("%-16s %14s %18s\n", "Method", "Avg time (ms)", "Avg expansions");
+    printf("%-16s %14.4f %18.1f\n", "D* Lite repair", repairMs, (double)repairExpansions / edits);
+    printf("%-16s %14.4f %18.1f\n", "Full re-solve", fullMs, (double)fullExpansions / edits);
+    if (repairMs > 0) {
+        printf("Speedup: %.1fx\n", fullMs / repairMs);
+    }
+    printf("Path length mismatches: %d\n", mismatches);
+    printf("===================================\n");
+    
+    freeIncrementalPlanner(incremental);
+    freeIncrementalPlanner(fresh);
+    freeMaze(maze);
+}
+
 // Function to free stack memory
 void freeStack(Stack* stack) {
     while (!isStackEmpty(stack)) {
@@ -390,9 +2138,43 @@ void freeStack(Stack* stack) {
 }
 
 // Main function with menu-driven interface
-int main() {
+int main(int argc, char* argv[]) {
+    // Non-interactive benchmark target: maze_solver --benchmark [output.csv] [seeds]
+    if (argc > 1 && strcmp(argv[1], "--benchmark") == 0) {
+        FILE* out = argc > 2 ? fopen(argv[2], "w") : stdout;
+        int seedCount = argc > 3 ? atoi(argv[3]) : 3;
+        
+        if (out == NULL) {
+            printf("Error: Cannot open %s for writing\n", argv[2]);
+            return 1;
+        }
+        runSolverBenchmark(out, seedCount > 0 ? seedCount : 3);
+        if (out != stdout) {
+            fclose(out);
+        }
+        return 0;
+    }
+    
+    // Non-interactive batch target: maze_solver --batch-benchmark [maxThreads] [mazes] [size]
+    if (argc > 1 && strcmp(argv[1], "--batch-benchmark") == 0) {
+        int maxThreads = argc > 2 ? atoi(argv[2]) : detectCpuCount();
+        int mazeCount = argc > 3 ? atoi(argv[3]) : 200;
+        int size = argc > 4 ? atoi(argv[4]) : 256;
+        
+        if (maxThreads < 1 || mazeCount < 1 || size < 4 || size > BATCH_MAX_MAZE_SIZE) {
+            printf("Invalid batch benchmark parameters!\n");
+            return 1;
+        }
+        for (int engine = 0; engine < ENGINE_COUNT; engine++) {
+            benchmarkBatchSolving(mazeCount, size, 20, (SolverEngine)engine, maxThreads, 1);
+        }
+        return 0;
+    }
+    
     Maze* maze = createMaze(10, 20);
-    int choice, rows, cols;
+    int choice, rows, cols, edits, clusterSize, queries, engine;
+    unsigned int seed;
+    char fileName[100];
     
     printf("Welcome to Maze Solver with Backtracking!\n");
     printf("Navigate through mazes using stack-based pathfinding!\n\n");
@@ -406,7 +2188,14 @@ int main() {
         printf("5. Display solution\n");
         printf("6. Reset maze\n");
         printf("7. Edit maze manually\n");
-        printf("8. Exit\n");
+        printf("8. Plan path incrementally (D* Lite)\n");
+        printf("9. Benchmark incremental repair vs full re-solve\n");
+        printf("10. Plan path hierarchically (HPA*)\n");
+        printf("11. Benchmark hierarchical planner on a large maze\n");
+        printf("12. Solve quietly (choose engine)\n");
+        printf("13. Run solver benchmark sweep (CSV)\n");
+        printf("14. Benchmark batch solving on a worker pool\n");
+        printf("15. Exit\n");
         printf("Enter your choice: ");
         
         scanf("%d", &choice);
@@ -434,7 +2223,7 @@ int main() {
                 break;
                 
             case 4:
-                if (maze->rows == 0) {
+                if (!hasMazeLoaded(maze)) {
                     printf("No maze loaded! Please load or generate a maze first.\n");
                 } else {
                     resetMaze(maze); // Reset before solving
@@ -455,14 +2244,117 @@ int main() {
                 break;
                 
             case 8:
+                if (!hasMazeLoaded(maze)) {
+                    printf("No maze loaded! Please load or generate a maze first.\n");
+                } else {
+                    planMazeIncrementally(maze);
+                }
+                break;
+                
+            case 9:
+                printf("Enter benchmark maze dimensions (rows cols): ");
+                scanf("%d %d", &rows, &cols);
+                printf("Enter number of edits and random seed: ");
+                scanf("%d %u", &edits, &seed);
+                
+                if (rows > 3 && cols > 3 && edits > 0) {
+                    benchmarkIncrementalPlanner(rows, cols, edits, seed);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 10:
+                if (!hasMazeLoaded(maze)) {
+                    printf("No maze loaded! Please load or generate a maze first.\n");
+                    break;
+                }
+                printf("Enter cluster size (4-%d, default %d): ", HPA_MAX_CLUSTER_SIZE, HPA_DEFAULT_CLUSTER_SIZE);
+                scanf("%d", &clusterSize);
+                
+                if (clusterSize < 4 || clusterSize > HPA_MAX_CLUSTER_SIZE) {
+                    clusterSize = HPA_DEFAULT_CLUSTER_SIZE;
+                }
+                planMazeHierarchically(maze, clusterSize);
+                break;
+                
+            case 11:
+                printf("Enter maze dimensions (rows cols): ");
+                scanf("%d %d", &rows, &cols);
+                printf("Enter cluster size, queries, edits and random seed: ");
+                scanf("%d %d %d %u", &clusterSize, &queries, &edits, &seed);
+                
+                if (rows > 3 && cols > 3 && clusterSize >= 4 && clusterSize <= HPA_MAX_CLUSTER_SIZE &&
+                    queries > 0 && edits >= 0) {
+                    benchmarkHierarchicalPlanner(rows, cols, clusterSize, queries, edits, seed);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 12:
+                if (!hasMazeLoaded(maze)) {
+                    printf("No maze loaded! Please load or generate a maze first.\n");
+                    break;
+                }
+                printf("Engines: 0-backtracking, 1-D* Lite, 2-HPA*\n");
+                printf("Enter engine (0-%d): ", ENGINE_COUNT - 1);
+                scanf("%d", &engine);
+                
+                if (engine >= 0 && engine < ENGINE_COUNT) {
+                    SolveResult result = solveMazeQuiet(maze, (SolverEngine)engine, HPA_DEFAULT_CLUSTER_SIZE);
+                    displaySolveResult((SolverEngine)engine, &result);
+                } else {
+                    printf("Invalid engine!\n");
+                }
+                break;
+                
+            case 13:
+                {
+                    int seedCount;
+                    printf("Enter CSV output file name: ");
+                    scanf("%99s", fileName);
+                    printf("Enter number of seeds per configuration: ");
+                    scanf("%d", &seedCount);
+                    
+                    FILE* out = fopen(fileName, "w");
+                    if (out == NULL) {
+                        printf("Error: Cannot open %s for writing\n", fileName);
+                    } else {
+                        runSolverBenchmark(out, seedCount > 0 ? seedCount : 3);
+                        fclose(out);
+                        printf("Benchmark results written to %s\n", fileName);
+                    }
+                }
+                break;
+                
+            case 14:
+                {
+                    int mazeCount, mazeSize, maxThreads;
+                    printf("Enter number of mazes and maze size (4-%d): ", BATCH_MAX_MAZE_SIZE);
+                    scanf("%d %d", &mazeCount, &mazeSize);
+                    printf("Engines: 0-backtracking, 1-D* Lite, 2-HPA*\n");
+                    printf("Enter engine and maximum worker threads (%d CPUs detected): ", detectCpuCount());
+                    scanf("%d %d", &engine, &maxThreads);
+                    
+                    if (mazeCount > 0 && mazeSize > 3 && mazeSize <= BATCH_MAX_MAZE_SIZE && engine >= 0 && engine < ENGINE_COUNT && maxThreads > 0) {
+                        benchmarkBatchSolving(mazeCount, mazeSize, DEFAULT_WALL_PERCENT, (SolverEngine)engine,
+                                              maxThreads, 1);
+                    } else {
+                        printf("Invalid benchmark parameters!\n");
+                    }
+                }
+                break;
+                
+            case 15:
                 printf("Thanks for using Maze Solver!\n");
                 break;
                 
             default:
                 printf("Invalid choice! Please try again.\n");
         }
-    } while (choice != 8);
+    } while (choice != 15);
     
-    free(maze);
+    freeMaze(maze);
     return 0;
 }
\ No newline at end of file
@@ -7,10 +7,60 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdint.h>
+#include <stddef.h>
+#include <limits.h>
 #include <time.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <unistd.h>
+#include <signal.h>
+#include <setjmp.h>
+#include <sys/mman.h>
+#endif
 
-#define MAX_STACK_SIZE 1000
+#ifndef MAX_STACK_SIZE
+#define MAX_STACK_SIZE 1000  // Default budget; override with -DMAX_STACK_SIZE=<bytes>
+#endif
 #define MAX_BLOCK_SIZE 100
+#define BLOCK_ALIGNMENT 16   // Alignment of every header and payload in the arena
+#define SLAB_SIZE 4096       // Bytes per slab; slabs are SLAB_SIZE-aligned
+#define SLAB_CLASS_COUNT 12
+#define SLAB_MAX_OBJECT 1024 // Largest request served by the slab heap
+#define SLAB_HEAP_SIZE (64 * SLAB_SIZE)
+#define BUDDY_MIN_ORDER 5    // Smallest buddy block: 32 bytes (header + links)
+#define BUDDY_MAX_ORDER 40
+#define CACHE_LINE_SIZE 64
+#define HANDOFF_RING_SIZE 1024 // Objects in flight between two benchmark threads (power of two)
+#define TRACE_MAGIC 0x4352544DU  // "MTRC" little-endian
+#define TRACE_VERSION 1
+#define TRACE_RECORD_BYTES 10    // On-disk record: id (4), size (4), op (1), alignment log2 (1)
+#define RSS_SAMPLE_INTERVAL 1024 // Replay operations between RSS samples
+#define LEAK_INDEX_INITIAL 256   // Initial slots in the leak tracker's block index (power of two)
+#define HISTOGRAM_SUB_BITS 4     // 16 sub-buckets per power of two: values within 1/16
+#define HISTOGRAM_SUB_COUNT (1 << HISTOGRAM_SUB_BITS)
+#define HISTOGRAM_BUCKETS (HISTOGRAM_SUB_COUNT * 38) // Up to 2^41 ns (about 36 minutes)
+#define PROFILE_SAMPLE_INTERVAL 64 // Operations on one allocator between timeline samples
+#define BLOCK_TYPE_COUNT 5
+#define VSTACK_DEFAULT_RESERVE ((size_t)1 << 30) // Virtual stack mode reserves 1 GB by default
+#define VSTACK_RELEASE_THRESHOLD (64 * 1024)     // Freed tail bytes before pages go back to the OS
+#define TLSF_SL_LOG2 4           // 16 second-level lists per power of two
+#define TLSF_SL_COUNT (1 << TLSF_SL_LOG2)
+#define TLSF_FL_SHIFT (TLSF_SL_LOG2 + 4) // Below 256 bytes, one list per 16-byte size
+#define TLSF_SMALL_BLOCK (1 << TLSF_FL_SHIFT)
+#define TLSF_FL_MAX 40           // Blocks up to 1 TB
+#define TLSF_FL_COUNT (TLSF_FL_MAX - TLSF_FL_SHIFT + 1)
+#define TLSF_HEADER_SIZE 16      // prevPhys + size; free-list links overlay the payload
+#define TLSF_MIN_PAYLOAD 16
+#define TLSF_FREE_BIT ((size_t)1)
+#define COMPACT_HEADER_SIZE 16   // Payload size, handle and requested size in front of each block
+#define COMPACT_HANDLE_INITIAL 256
+#define COMPACT_DEAD_TRIGGER 8   // Start a compaction cycle once dead bytes reach 1/8 of the heap
+#define COMPACT_SLICE_INTERVAL 64 // Benchmark operations between compaction slices
 
 // Enumeration for memory block types
 typedef enum {
@@ -29,18 +79,363 @@ typedef struct MemoryBlock {
     void* data;
     size_t size;
     time_t allocTime;
+    unsigned int traceId;    // Lifetime id in the active trace (0 if not recorded)
+    size_t alignment;        // Payload alignment (16, 32 or 64)
+    size_t padding;          // Arena bytes spent on alignment beyond the default layout
     struct MemoryBlock* next;
 } MemoryBlock;
 
-// Structure to represent the memory stack
+// Structure to represent the memory stack.
+// Blocks live in one contiguous arena: each MemoryBlock header sits directly
+// before its payload, so allocation bumps arenaUsed and deallocation rolls it back.
 typedef struct MemoryStack {
     MemoryBlock* top;
     int totalBlocks;
     size_t totalMemoryUsed;
     size_t maxMemoryUsed;
     int nextBlockId;
+    size_t capacity;         // Payload budget in bytes (MAX_STACK_SIZE by default)
+    unsigned char* arena;    // Pre-reserved region for headers and payloads
+    size_t arenaSize;
+    size_t arenaUsed;        // Bump offset where the next header starts
+    size_t paddingBytes;     // Alignment padding of live blocks
+    int virtualArena;        // 1 if the arena is a reserved virtual range with a guard page
+    size_t pageSize;
+    size_t guardOffset;      // Start of the guard page (end of the usable range)
+    size_t touchedBytes;     // Page-rounded high-water of the arena since the last release
+    int releaseToOs;         // madvise freed tail pages back to the OS
+    long pagesReleased;
 } MemoryStack;
 
+// Structure to record the stack state at scope entry (a watermark)
+typedef struct StackMark {
+    MemoryBlock* top;
+    size_t arenaUsed;
+    int totalBlocks;
+    size_t totalMemoryUsed;
+    size_t paddingBytes;
+} StackMark;
+
+// Slot sizes of the segregated size classes (all multiples of BLOCK_ALIGNMENT)
+static const size_t slabClassSizes[SLAB_CLASS_COUNT] = {
+    16, 32, 48, 64, 96, 128, 192, 256, 384, 512, 768, 1024
+};
+
+// Structure to represent one slab: a SLAB_SIZE page of equal-sized slots.
+// The header sits at the start of the slab, so a slot's slab is found by
+// rounding its address down to SLAB_SIZE.
+typedef struct Slab {
+    struct Slab* next;       // Link in the class's partial list or the free-slab list
+    struct Slab* prev;
+    struct SlabHeap* heap;   // Heap that owns the slab (finds the owning thread arena)
+    void* freeList;          // Slots freed back to this slab
+    size_t bumpOffset;       // Next never-used slot; slots are carved lazily
+    int classIndex;          // -1 while the slab is unassigned
+    int usedSlots;
+    int totalSlots;
+} Slab;
+
+// Structure to represent the slab heap mode: out-of-order frees of small
+// objects served from per-class slabs carved out of one fixed region
+typedef struct SlabHeap {
+    unsigned char* region;   // Raw allocation (over-allocated for alignment)
+    unsigned char* base;     // First slab, aligned to SLAB_SIZE
+    size_t capacity;         // Bytes available for slabs
+    int slabCount;
+    Slab* freeSlabs;         // Slabs not assigned to any class
+    Slab* partial[SLAB_CLASS_COUNT]; // Slabs of each class with at least one free slot
+    int slabsInUse[SLAB_CLASS_COUNT];
+    int liveObjects[SLAB_CLASS_COUNT];
+    int totalBlocks;
+    size_t totalMemoryUsed;  // Requested bytes of live objects
+    size_t slotBytesUsed;    // Slot bytes of live objects (requested + rounding)
+    size_t paddingBytes;     // Slot bytes beyond the natural class, spent on alignment
+    size_t maxMemoryUsed;
+    long failedAllocations;
+    struct ThreadArena* owner; // Thread arena using this heap, NULL for shared heaps
+} SlabHeap;
+
+// Structure to represent a buddy block header. Only the first fields are
+// kept while the block is allocated; the links reuse the payload when free.
+typedef struct BuddyBlock {
+    unsigned int order;      // Block size is 1 << order bytes
+    unsigned short isFree;
+    unsigned short payloadOffset; // Payload distance from the block start (16, 32 or 64)
+    size_t requested;        // Requested payload bytes while allocated
+    struct BuddyBlock* next; // Free-list links, valid only while free
+    struct BuddyBlock* prev;
+} BuddyBlock;
+
+#define BUDDY_HEADER_SIZE (offsetof(BuddyBlock, next))
+// Aligned payloads sit further into the block; a copy of the header sits
+// right before the payload so buddyFree() can find the block start.
+
+// Structure to represent the buddy allocator mode: one power-of-two region
+// split in halves on demand and coalesced with its buddy on free
+typedef struct BuddyAllocator {
+    unsigned char* rawRegion;  // Allocation backing the region
+    unsigned char* region;     // Region start, aligned to CACHE_LINE_SIZE
+    size_t capacity;         // Region size, a power of two
+    unsigned int maxOrder;
+    BuddyBlock* freeLists[BUDDY_MAX_ORDER + 1];
+    int freeCounts[BUDDY_MAX_ORDER + 1];
+    int totalBlocks;
+    size_t totalMemoryUsed;  // Requested bytes of live allocations
+    size_t maxMemoryUsed;
+    size_t blockBytesUsed;   // Bytes of allocated blocks (requested + header + rounding)
+    size_t highWaterMark;    // Peak of blockBytesUsed
+    size_t paddingBytes;     // Header space added by alignment in live blocks
+    long failedAllocations;
+} BuddyAllocator;
+
+// Structure to represent one allocation site (source file and line)
+typedef struct AllocationSite {
+    const char* file;
+    int line;
+    int liveBlocks;
+    size_t liveBytes;
+    long totalAllocations;
+} AllocationSite;
+
+// One slot of the leak tracker's block index (blockId 0 marks an empty slot)
+typedef struct LeakEntry {
+    int blockId;
+    int siteIndex;
+    MemoryBlock* block;
+} LeakEntry;
+
+// Structure to represent the leak tracker: live blocks in an open-addressing
+// hash index keyed by blockId, each tagged with the site that allocated it
+typedef struct LeakTracker {
+    LeakEntry* entries;
+    size_t capacity;             // Power of two
+    size_t count;
+    AllocationSite* sites;
+    int siteCount;
+    int siteCapacity;
+    int* siteSlots;              // Hash of (file, line) -> site index + 1
+    int siteSlotCapacity;        // Power of two, kept above twice siteCount
+} LeakTracker;
+
+// Allocator operations timed by the profiler
+typedef enum {
+    PROFILE_STACK_ALLOC,
+    PROFILE_STACK_FREE,
+    PROFILE_STACK_RELEASE,
+    PROFILE_SLAB_ALLOC,
+    PROFILE_SLAB_FREE,
+    PROFILE_BUDDY_ALLOC,
+    PROFILE_BUDDY_FREE,
+    PROFILE_TLSF_ALLOC,
+    PROFILE_TLSF_FREE,
+    PROFILE_COMPACT_ALLOC,
+    PROFILE_COMPACT_FREE,
+    PROFILE_OP_COUNT
+} ProfileOp;
+
+// HDR-style latency histogram: exact below 16 ns, then 16 linear
+// sub-buckets per power of two, so every bucket is within 1/16 of its value
+typedef struct LatencyHistogram {
+    long counts[HISTOGRAM_BUCKETS];
+    long totalCount;
+    unsigned long long minNs;
+    unsigned long long maxNs;
+    double sumNs;
+} LatencyHistogram;
+
+// One sample of an allocator's usage over time
+typedef struct TimelineSample {
+    double timeMs;               // Since profiling started
+    int allocator;               // ProfileOp of the operation that took the sample
+    size_t bytes;
+    int blocks;
+} TimelineSample;
+
+// Per-BlockType usage of the stack
+typedef struct BlockTypeStats {
+    long allocations;
+    int liveBlocks;
+    size_t liveBytes;
+    size_t peakBytes;
+    size_t paddingBytes;
+} BlockTypeStats;
+
+// Structure to represent the allocator profiler
+typedef struct AllocatorProfile {
+    double startNs;
+    LatencyHistogram histograms[PROFILE_OP_COUNT];
+    long opCounts[PROFILE_OP_COUNT];
+    TimelineSample* timeline;
+    size_t timelineCount;
+    size_t timelineCapacity;
+    BlockTypeStats types[BLOCK_TYPE_COUNT];
+} AllocatorProfile;
+
+// Operations recorded in an allocation trace
+typedef enum {
+    TRACE_ALLOC,
+    TRACE_FREE
+} TraceOp;
+
+// One allocation trace event. A free names the allocation by its lifetime id.
+typedef struct TraceRecord {
+    unsigned int lifetimeId;     // Dense ids starting at 1, assigned at allocation
+    unsigned int size;
+    unsigned char op;            // TraceOp
+    unsigned char alignmentLog2;
+} TraceRecord;
+
+// Structure to represent an allocation trace in memory
+typedef struct AllocationTrace {
+    TraceRecord* records;
+    size_t count;
+    size_t capacity;
+    unsigned int nextLifetimeId;
+} AllocationTrace;
+
+// Allocator engines the replay driver can drive
+typedef enum {
+    REPLAY_MALLOC,
+    REPLAY_SLAB,
+    REPLAY_BUDDY,
+    REPLAY_TLSF,
+    REPLAY_ENGINE_COUNT
+} ReplayEngine;
+
+// Results of replaying one trace against one engine
+typedef struct ReplayResult {
+    long operations;
+    long failedAllocations;
+    double elapsedNs;
+    double p50Ns, p90Ns, p99Ns, p999Ns, maxNs;
+    size_t peakLiveBytes;
+    size_t peakFootprint;        // Allocator bytes backing live objects at the peak (0 if unknown)
+    size_t peakRssDelta;         // Growth of resident memory over the replay
+} ReplayResult;
+
+// Structure to represent a TLSF block header. Blocks tile the region in
+// address order; prevPhys links to the block before, and the block after
+// starts right past the payload. The links are valid only while free.
+typedef struct TlsfBlock {
+    struct TlsfBlock* prevPhys;
+    size_t size;                 // Payload bytes (multiple of 16) | TLSF_FREE_BIT
+    struct TlsfBlock* nextFree;
+    struct TlsfBlock* prevFree;
+} TlsfBlock;
+
+// Structure to represent the Two-Level Segregated Fit allocator: free lists
+// indexed by power of two (first level) and 16 linear steps inside it
+// (second level), with bitmaps so malloc and free are O(1)
+typedef struct TlsfAllocator {
+    unsigned char* rawRegion;
+    unsigned char* region;       // Aligned to CACHE_LINE_SIZE
+    size_t capacity;
+    unsigned long long flBitmap;
+    unsigned int slBitmap[TLSF_FL_COUNT];
+    TlsfBlock* freeLists[TLSF_FL_COUNT][TLSF_SL_COUNT];
+    int totalBlocks;
+    int freeBlocks;
+    size_t totalMemoryUsed;      // Requested bytes of live allocations
+    size_t maxMemoryUsed;
+    size_t blockBytesUsed;       // Headers and payloads of live blocks
+    size_t highWaterMark;        // Peak of blockBytesUsed
+    long failedAllocations;
+} TlsfAllocator;
+
+// Handle to a block of the compacting heap (0 is the null handle). Callers
+// keep handles; a pointer from compactDeref() is valid only until the next
+// allocation or compaction slice, which may move the block.
+typedef unsigned int MemoryHandle;
+
+// Header in front of every compacting heap block. Blocks tile the heap from
+// offset 0 in address order; a freed block keeps its place (handle 0) until
+// the compactor slides the live blocks after it over it.
+typedef struct CompactHeader {
+    size_t size;                 // Payload bytes, a multiple of 16
+    unsigned int handle;         // 0 once the block is dead
+    unsigned int requested;
+} CompactHeader;
+
+// One entry of the handle table
+typedef struct CompactSlot {
+    size_t offset;               // Payload offset in the region while live
+    unsigned int nextFree;       // Next unused handle while this one is unused
+    int live;
+} CompactSlot;
+
+// Structure to represent the handle-based compacting heap: a bump region
+// whose dead blocks are reclaimed by an incremental sliding compactor
+typedef struct CompactingHeap {
+    unsigned char* rawRegion;
+    unsigned char* region;       // Aligned to CACHE_LINE_SIZE
+    size_t capacity;
+    size_t top;                  // Bump offset: blocks tile [0, top)
+    CompactSlot* handles;        // Indexed by handle; entry 0 is unused
+    unsigned int handleCapacity;
+    unsigned int freeHandle;     // Head of the unused handle list (0 if empty)
+    int totalBlocks;
+    size_t totalMemoryUsed;      // Requested bytes of live blocks
+    size_t maxMemoryUsed;
+    size_t blockBytesUsed;       // Headers and payloads of live blocks
+    size_t deadBytes;            // Headers and payloads of freed blocks still in [0, top)
+    int compacting;              // 1 while a cycle is in progress
+    size_t compactScan;          // Next block the current cycle visits
+    size_t compactWrite;         // Blocks below this offset are packed
+    size_t firstDead;            // Lowest dead block the next cycle must visit (capacity if none)
+    long cycles;
+    long slices;
+    long fullCompactions;        // Cycles finished at once because an allocation needed room
+    size_t bytesMoved;
+    size_t bytesReclaimed;
+    long failedAllocations;
+    LatencyHistogram pauses;     // Duration of every slice and full compaction
+} CompactingHeap;
+
+// Node written into a freed object while it waits in its owner's remote-free queue
+typedef struct RemoteFree {
+    struct RemoteFree* next;
+    size_t size;
+} RemoteFree;
+
+// Structure to represent a per-thread arena: a private slab heap used without
+// locks by its owner. Other threads hand frees back through a lock-free
+// queue, and the owner publishes its counters so stats can be merged any time.
+typedef struct ThreadArena {
+    _Atomic(RemoteFree*) remoteFrees; // Written by any thread, drained by the owner
+    char padding[CACHE_LINE_SIZE];    // Keep the shared queue head off the owner's line
+    SlabHeap* heap;
+    atomic_int liveBlocks;            // Published by the owner after each operation
+    atomic_size_t liveBytes;
+    atomic_size_t maxBytes;
+    atomic_size_t paddingBytes;
+    atomic_long allocations;
+    atomic_long localFrees;
+    atomic_long remoteFreesSent;
+    atomic_long remoteFreesReceived;
+    atomic_long failedAllocations;
+} ThreadArena;
+
+// Structure to represent a set of thread arenas, one per worker thread
+typedef struct ThreadArenaPool {
+    ThreadArena** arenas;
+    int count;
+} ThreadArenaPool;
+
+// Aggregate thread arena statistics, merged on demand
+typedef struct ThreadArenaStats {
+    int totalBlocks;
+    size_t totalMemoryUsed;
+    size_t maxMemoryUsed;        // Sum of per-arena peaks
+    size_t paddingBytes;
+    size_t capacity;
+    long allocations;
+    long localFrees;
+    long remoteFreesSent;
+    long remoteFreesReceived;
+    long remoteFreesPending;
+    long failedAllocations;
+} ThreadArenaStats;
+
 // Function to get block type string
 const char* getBlockTypeString(BlockType type) {
     switch (type) {
@@ -53,44 +448,734 @@ const char* getBlockTypeString(BlockType type) {
     }
 }
 
-// Function to create a memory stack
-MemoryStack* createMemoryStack() {
+// Function to round a size up to a multiple of the alignment (a power of two)
+size_t alignUp(size_t size, size_t alignment) {
+    return (size + alignment - 1) & ~(alignment - 1);
+}
+
+// Function to get the arena bytes a block of the given payload size occupies
+size_t getArenaBlockSize(size_t size) {
+    return alignUp(sizeof(MemoryBlock), BLOCK_ALIGNMENT) + alignUp(size, BLOCK_ALIGNMENT);
+}
+
+// Function to check a requested alignment: returns the alignment to use
+// (16, 32 or 64; smaller requests get 16) or 0 if it is not supported
+size_t normalizeAlignment(size_t alignment) {
+    if (alignment <= BLOCK_ALIGNMENT) {
+        return BLOCK_ALIGNMENT;
+    }
+    if (alignment > CACHE_LINE_SIZE || (alignment & (alignment - 1)) != 0) {
+        return 0;
+    }
+    return alignment;
+}
+
+// Function to get the granularity a payload is rounded to. Cache-line aligned
+// payloads fill whole lines, so no neighbour shares their last line (no false sharing).
+size_t getPayloadGranularity(size_t alignment) {
+    return alignment >= CACHE_LINE_SIZE ? CACHE_LINE_SIZE : BLOCK_ALIGNMENT;
+}
+
+// Function to print the alignment padding line shared by the statistics displays
+void printAlignmentPadding(size_t paddingBytes, size_t used) {
+    printf("Alignment padding: %zu bytes (%.1f%% of memory used)\n", paddingBytes,
+           used > 0 ? (float)paddingBytes / used * 100 : 0.0f);
+}
+
+// Function to read a monotonic timestamp in nanoseconds for benchmarks.
+// The wall clock can step under NTP, which would skew or negate latencies.
+double currentTimeNs() {
+#ifdef _WIN32
+    static LARGE_INTEGER frequency;
+    LARGE_INTEGER now;
+    if (frequency.QuadPart == 0) {
+        QueryPerformanceFrequency(&frequency);
+    }
+    QueryPerformanceCounter(&now);
+    return (double)now.QuadPart * 1e9 / (double)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return now.tv_sec * 1e9 + now.tv_nsec;
+#endif
+}
+
+// Profiler the allocators report to. Thread-local, so only the thread that
+// started profiling pays for it and worker threads never race on it.
+static _Thread_local AllocatorProfile* allocatorProfile = NULL;
+
+// Function to create a profiler with empty histograms
+AllocatorProfile* createAllocatorProfile() {
+    AllocatorProfile* profile = (AllocatorProfile*)calloc(1, sizeof(AllocatorProfile));
+    profile->startNs = currentTimeNs();
+    profile->timelineCapacity = 1024;
+    profile->timeline = (TimelineSample*)malloc(profile->timelineCapacity * sizeof(TimelineSample));
+    for (int op = 0; op < PROFILE_OP_COUNT; op++) {
+        profile->histograms[op].minNs = ~0ULL;
+    }
+    return profile;
+}
+
+// Function to free a profiler
+void freeAllocatorProfile(AllocatorProfile* profile) {
+    if (profile != NULL) {
+        free(profile->timeline);
+        free(profile);
+    }
+}
+
+// Function to get the display name of a profiled operation
+const char* getProfileOpName(ProfileOp op) {
+    switch (op) {
+        case PROFILE_STACK_ALLOC: return "stack_alloc";
+        case PROFILE_STACK_FREE: return "stack_free";
+        case PROFILE_STACK_RELEASE: return "stack_release";
+        case PROFILE_SLAB_ALLOC: return "slab_alloc";
+        case PROFILE_SLAB_FREE: return "slab_free";
+        case PROFILE_BUDDY_ALLOC: return "buddy_alloc";
+        case PROFILE_BUDDY_FREE: return "buddy_free";
+        case PROFILE_TLSF_ALLOC: return "tlsf_alloc";
+        case PROFILE_TLSF_FREE: return "tlsf_free";
+        case PROFILE_COMPACT_ALLOC: return "compact_alloc";
+        case PROFILE_COMPACT_FREE: return "compact_free";
+        default: return "unknown";
+    }
+}
+
+// Function to get the allocator name of a profiled operation
+const char* getProfileAllocatorName(ProfileOp op) {
+    switch (op) {
+        case PROFILE_STACK_ALLOC:
+        case PROFILE_STACK_FREE:
+        case PROFILE_STACK_RELEASE: return "stack";
+        case PROFILE_SLAB_ALLOC:
+        case PROFILE_SLAB_FREE: return "slab";
+        case PROFILE_BUDDY_ALLOC:
+        case PROFILE_BUDDY_FREE: return "buddy";
+        case PROFILE_TLSF_ALLOC:
+        case PROFILE_TLSF_FREE: return "tlsf";
+        case PROFILE_COMPACT_ALLOC:
+        case PROFILE_COMPACT_FREE: return "compact";
+        default: return "unknown";
+    }
+}
+
+// Function to map a latency to its histogram bucket
+int getHistogramBucket(unsigned long long ns) {
+    if (ns < HISTOGRAM_SUB_COUNT) {
+        return (int)ns;
+    }
+    int exponent = 63 - __builtin_clzll(ns);
+    int bucket = HISTOGRAM_SUB_COUNT * (exponent - HISTOGRAM_SUB_BITS + 1) +
+                 (int)((ns >> (exponent - HISTOGRAM_SUB_BITS)) - HISTOGRAM_SUB_COUNT);
+    return bucket < HISTOGRAM_BUCKETS ? bucket : HISTOGRAM_BUCKETS - 1;
+}
+
+// Function to get the lowest latency that falls into a bucket
+unsigned long long getHistogramBucketLow(int bucket) {
+    if (bucket < HISTOGRAM_SUB_COUNT) {
+        return (unsigned long long)bucket;
+    }
+    int shift = bucket / HISTOGRAM_SUB_COUNT - 1;
+    return (unsigned long long)(HISTOGRAM_SUB_COUNT + bucket % HISTOGRAM_SUB_COUNT) << shift;
+}
+
+// Function to get the highest latency that falls into a bucket
+unsigned long long getHistogramBucketHigh(int bucket) {
+    return getHistogramBucketLow(bucket + 1) - 1;
+}
+
+// Function to add one latency to a histogram in O(1)
+void recordLatency(LatencyHistogram* histogram, unsigned long long ns) {
+    histogram->counts[getHistogramBucket(ns)]++;
+    histogram->totalCount++;
+    histogram->sumNs += (double)ns;
+    if (ns < histogram->minNs) {
+        histogram->minNs = ns;
+    }
+    if (ns > histogram->maxNs) {
+        histogram->maxNs = ns;
+    }
+}
+
+// Function to get a percentile (0-100) from a histogram: the upper edge of
+// the bucket holding it, capped at the largest value seen
+unsigned long long getHistogramPercentile(LatencyHistogram* histogram, double percentile) {
+    if (histogram->totalCount == 0) {
+        return 0;
+    }
+    
+    long target = (long)(histogram->totalCount * percentile / 100.0 + 0.5);
+    long seen = 0;
+    if (target < 1) {
+        target = 1;
+    }
+    
+    for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+        seen += histogram->counts[bucket];
+        if (seen >= target) {
+            unsigned long long high = getHistogramBucketHigh(bucket);
+            return high < histogram->maxNs ? high : histogram->maxNs;
+        }
+    }
+    return histogram->maxNs;
+}
+
+// Function to start timing an allocator operation (0 when not profiling)
+double profileBegin() {
+    return allocatorProfile != NULL ? currentTimeNs() : 0.0;
+}
+
+// Function to finish timing an operation and take a timeline sample every
+// PROFILE_SAMPLE_INTERVAL operations of the same allocator
+void profileEnd(ProfileOp op, double begin, size_t liveBytes, int liveBlocks) {
+    AllocatorProfile* profile = allocatorProfile;
+    if (profile == NULL) {
+        return;
+    }
+    
+    double now = currentTimeNs();
+    recordLatency(&profile->histograms[op], (unsigned long long)(now - begin));
+    
+    if (profile->opCounts[op]++ % PROFILE_SAMPLE_INTERVAL == 0) {
+        if (profile->timelineCount == profile->timelineCapacity) {
+            profile->timelineCapacity *= 2;
+            profile->timeline = (TimelineSample*)realloc(profile->timeline,
+                                                         profile->timelineCapacity * sizeof(TimelineSample));
+        }
+        TimelineSample* sample = &profile->timeline[profile->timelineCount++];
+        sample->timeMs = (now - profile->startNs) / 1e6;
+        sample->allocator = op;
+        sample->bytes = liveBytes;
+        sample->blocks = liveBlocks;
+    }
+}
+
+// Function to account a stack block in the per-type breakdown
+void profileBlockType(MemoryBlock* block, int allocated) {
+    AllocatorProfile* profile = allocatorProfile;
+    if (profile == NULL || (int)block->type < 0 || (int)block->type >= BLOCK_TYPE_COUNT) {
+        return;
+    }
+    
+    BlockTypeStats* stats = &profile->types[block->type];
+    if (allocated) {
+        stats->allocations++;
+        stats->liveBlocks++;
+        stats->liveBytes += block->size;
+        stats->paddingBytes += block->padding;
+        if (stats->liveBytes > stats->peakBytes) {
+            stats->peakBytes = stats->liveBytes;
+        }
+    } else {
+        stats->liveBlocks--;
+        stats->liveBytes -= block->size;
+        stats->paddingBytes -= block->padding;
+    }
+}
+
+// Trace that allocateMemory()/deallocateMemory() report to (NULL while not recording)
+static AllocationTrace* traceRecorder = NULL;
+
+// Function to create an empty allocation trace
+AllocationTrace* createAllocationTrace() {
+    AllocationTrace* trace = (AllocationTrace*)malloc(sizeof(AllocationTrace));
+    trace->capacity = 1024;
+    trace->count = 0;
+    trace->records = (TraceRecord*)malloc(trace->capacity * sizeof(TraceRecord));
+    trace->nextLifetimeId = 1;
+    return trace;
+}
+
+// Function to free an allocation trace
+void freeAllocationTrace(AllocationTrace* trace) {
+    if (trace != NULL) {
+        free(trace->records);
+        free(trace);
+    }
+}
+
+// Function to append one record to a trace, growing it geometrically
+void appendTraceRecord(AllocationTrace* trace, TraceOp op, unsigned int lifetimeId, size_t size,
+                       size_t alignment) {
+    if (trace->count == trace->capacity) {
+        trace->capacity *= 2;
+        trace->records = (TraceRecord*)realloc(trace->records, trace->capacity * sizeof(TraceRecord));
+    }
+    
+    unsigned char alignmentLog2 = 0;
+    while (((size_t)1 << alignmentLog2) < alignment) {
+        alignmentLog2++;
+    }
+    
+    TraceRecord* record = &trace->records[trace->count++];
+    record->lifetimeId = lifetimeId;
+    record->size = (unsigned int)size;
+    record->op = (unsigned char)op;
+    record->alignmentLog2 = alignmentLog2;
+}
+
+// Recorder hook for allocations: returns the new lifetime id (0 when not recording)
+unsigned int traceRecordAlloc(size_t size, size_t alignment) {
+    if (traceRecorder == NULL) {
+        return 0;
+    }
+    unsigned int lifetimeId = traceRecorder->nextLifetimeId++;
+    appendTraceRecord(traceRecorder, TRACE_ALLOC, lifetimeId, size, alignment);
+    return lifetimeId;
+}
+
+// Recorder hook for frees of an allocation recorded under lifetimeId
+void traceRecordFree(unsigned int lifetimeId) {
+    if (traceRecorder != NULL && lifetimeId != 0) {
+        appendTraceRecord(traceRecorder, TRACE_FREE, lifetimeId, 0, 1);
+    }
+}
+
+// Leak tracker that allocateMemory()/deallocateMemory() report to (NULL while off)
+static LeakTracker* leakTracker = NULL;
+
+// Function to create an empty leak tracker
+LeakTracker* createLeakTracker() {
+    LeakTracker* tracker = (LeakTracker*)malloc(sizeof(LeakTracker));
+    tracker->capacity = LEAK_INDEX_INITIAL;
+    tracker->count = 0;
+    tracker->entries = (LeakEntry*)calloc(tracker->capacity, sizeof(LeakEntry));
+    tracker->siteCapacity = 16;
+    tracker->siteCount = 0;
+    tracker->sites = (AllocationSite*)malloc(tracker->siteCapacity * sizeof(AllocationSite));
+    tracker->siteSlotCapacity = 32;
+    tracker->siteSlots = (int*)calloc(tracker->siteSlotCapacity, sizeof(int));
+    return tracker;
+}
+
+// Function to free a leak tracker
+void freeLeakTracker(LeakTracker* tracker) {
+    if (tracker != NULL) {
+        free(tracker->entries);
+        free(tracker->sites);
+        free(tracker->siteSlots);
+        free(tracker);
+    }
+}
+
+// Function to hash a block id to its home slot (Fibonacci hashing: the top
+// bits of the product, which depend on every bit of the id)
+size_t hashBlockId(int blockId, size_t capacity) {
+    int bits = __builtin_ctzll((unsigned long long)capacity);
+    return (size_t)(((unsigned long long)(unsigned int)blockId * 11400714819323198485ULL) >> (64 - bits));
+}
+
+// Function to hash an allocation site to its home slot
+int hashAllocationSite(const char* file, int line, int capacity) {
+    uintptr_t h = (uintptr_t)file ^ ((uintptr_t)line * 2654435761U);
+    h ^= h >> 15;
+    return (int)(h & (uintptr_t)(capacity - 1));
+}
+
+// Function to find or add the site for (file, line). File names are
+// string literals from __FILE__, so they are compared by pointer first.
+int getAllocationSite(LeakTracker* tracker, const char* file, int line) {
+    int slot = hashAllocationSite(file, line, tracker->siteSlotCapacity);
+    
+    while (tracker->siteSlots[slot] != 0) {
+        AllocationSite* site = &tracker->sites[tracker->siteSlots[slot] - 1];
+        if (site->line == line && (site->file == file || strcmp(site->file, file) == 0)) {
+            return tracker->siteSlots[slot] - 1;
+        }
+        slot = (slot + 1) & (tracker->siteSlotCapacity - 1);
+    }
+    
+    if (tracker->siteCount == tracker->siteCapacity) {
+        tracker->siteCapacity *= 2;
+        tracker->sites = (AllocationSite*)realloc(tracker->sites, tracker->siteCapacity * sizeof(AllocationSite));
+    }
+    
+    int index = tracker->siteCount++;
+    AllocationSite* site = &tracker->sites[index];
+    site->file = file;
+    site->line = line;
+    site->liveBlocks = 0;
+    site->liveBytes = 0;
+    site->totalAllocations = 0;
+    tracker->siteSlots[slot] = index + 1;
+    
+    // Keep the site hash at most half full
+    if (tracker->siteCount * 2 > tracker->siteSlotCapacity) {
+        tracker->siteSlotCapacity *= 2;
+        free(tracker->siteSlots);
+        tracker->siteSlots = (int*)calloc(tracker->siteSlotCapacity, sizeof(int));
+        for (int i = 0; i < tracker->siteCount; i++) {
+            int rehashed = hashAllocationSite(tracker->sites[i].file, tracker->sites[i].line,
+                                              tracker->siteSlotCapacity);
+            while (tracker->siteSlots[rehashed] != 0) {
+                rehashed = (rehashed + 1) & (tracker->siteSlotCapacity - 1);
+            }
+            tracker->siteSlots[rehashed] = i + 1;
+        }
+    }
+    
+    return index;
+}
+
+// Function to insert an entry into the block index without growing it
+void insertLeakEntry(LeakTracker* tracker, LeakEntry entry) {
+    size_t slot = hashBlockId(entry.blockId, tracker->capacity);
+    while (tracker->entries[slot].blockId != 0) {
+        slot = (slot + 1) & (tracker->capacity - 1);
+    }
+    tracker->entries[slot] = entry;
+    tracker->count++;
+}
+
+// Function to record a new live block and its allocation site in O(1)
+void leakTrackBlock(LeakTracker* tracker, MemoryBlock* block, const char* file, int line) {
+    // Grow at 70% load so probe sequences stay short
+    if ((tracker->count + 1) * 10 > tracker->capacity * 7) {
+        LeakEntry* oldEntries = tracker->entries;
+        size_t oldCapacity = tracker->capacity;
+        
+        tracker->capacity *= 2;
+        tracker->entries = (LeakEntry*)calloc(tracker->capacity, sizeof(LeakEntry));
+        tracker->count = 0;
+        for (size_t i = 0; i < oldCapacity; i++) {
+            if (oldEntries[i].blockId != 0) {
+                insertLeakEntry(tracker, oldEntries[i]);
+            }
+        }
+        free(oldEntries);
+    }
+    
+    LeakEntry entry;
+    entry.blockId = block->blockId;
+    entry.siteIndex = getAllocationSite(tracker, file, line);
+    entry.block = block;
+    insertLeakEntry(tracker, entry);
+    
+    AllocationSite* site = &tracker->sites[entry.siteIndex];
+    site->liveBlocks++;
+    site->liveBytes += block->size;
+    site->totalAllocations++;
+}
+
+// Function to index the blocks that were already live when tracking was
+// turned on, so the index covers every live block. Their site is unknown.
+void leakTrackExistingBlocks(LeakTracker* tracker, MemoryStack* stack) {
+    for (MemoryBlock* block = stack->top; block != NULL; block = block->next) {
+        leakTrackBlock(tracker, block, "(allocated before tracking)", 0);
+    }
+}
+
+// Function to find the slot holding blockId (-1 if it is not tracked)
+long findLeakSlot(LeakTracker* tracker, int blockId) {
+    size_t slot = hashBlockId(blockId, tracker->capacity);
+    while (tracker->entries[slot].blockId != 0) {
+        if (tracker->entries[slot].blockId == blockId) {
+            return (long)slot;
+        }
+        slot = (slot + 1) & (tracker->capacity - 1);
+    }
+    return -1;
+}
+
+// Function to look up a live block by id in O(1) (NULL if not tracked)
+MemoryBlock* findTrackedBlock(LeakTracker* tracker, int blockId) {
+    long slot = findLeakSlot(tracker, blockId);
+    return slot >= 0 ? tracker->entries[slot].block : NULL;
+}
+
+// Function to remove a freed block from the index. Uses backward-shift
+// deletion so no tombstones accumulate while the tracker stays on.
+void leakUntrackBlock(LeakTracker* tracker, int blockId) {
+    long found = findLeakSlot(tracker, blockId);
+    if (found < 0) {
+        return;
+    }
+    
+    size_t hole = (size_t)found;
+    AllocationSite* site = &tracker->sites[tracker->entries[hole].siteIndex];
+    site->liveBlocks--;
+    site->liveBytes -= tracker->entries[hole].block->size;
+    
+    size_t slot = hole;
+    for (;;) {
+        slot = (slot + 1) & (tracker->capacity - 1);
+        if (tracker->entries[slot].blockId == 0) {
+            break;
+        }
+        // Move the entry back if the hole lies between its home slot and its slot
+        size_t home = hashBlockId(tracker->entries[slot].blockId, tracker->capacity);
+        if (((slot - home) & (tracker->capacity - 1)) >= ((slot - hole) & (tracker->capacity - 1))) {
+            tracker->entries[hole] = tracker->entries[slot];
+            hole = slot;
+        }
+    }
+    tracker->entries[hole].blockId = 0;
+    tracker->count--;
+}
+
+// Function to compare sites by live bytes, largest first, for the leak report
+int compareSitesByLiveBytes(const void* a, const void* b) {
+    const AllocationSite* left = (const AllocationSite*)a;
+    const AllocationSite* right = (const AllocationSite*)b;
+    return (left->liveBytes < right->liveBytes) - (left->liveBytes > right->liveBytes);
+}
+
+// Function to print live blocks grouped by allocation site; returns leaked bytes
+size_t reportLeaks(LeakTracker* tracker) {
+    AllocationSite* sites = (AllocationSite*)malloc((tracker->siteCount + 1) * sizeof(AllocationSite));
+    int leakingSites = 0;
+    size_t leakedBytes = 0;
+    
+    for (int i = 0; i < tracker->siteCount; i++) {
+        if (tracker->sites[i].liveBlocks > 0) {
+            sites[leakingSites++] = tracker->sites[i];
+            leakedBytes += tracker->sites[i].liveBytes;
+        }
+    }
+    qsort(sites, leakingSites, sizeof(AllocationSite), compareSitesByLiveBytes);
+    
+    printf("\n=== LEAK REPORT ===\n");
+    if (leakingSites == 0) {
+        printf("No live blocks - nothing leaked.\n");
+    } else {
+        printf("%zu blocks (%zu bytes) still live from %d sites:\n", tracker->count, leakedBytes, leakingSites);
+        printf("%-32s %8s %10s %12s\n", "Site", "Blocks", "Bytes", "Allocations");
+        for (int i = 0; i < leakingSites; i++) {
+            char location[300];
+            snprintf(location, sizeof(location), "%s:%d", sites[i].file, sites[i].line);
+            printf("%-32s %8d %10zu %12ld\n", location, sites[i].liveBlocks, sites[i].liveBytes,
+                   sites[i].totalAllocations);
+        }
+    }
+    printf("===================\n");
+    
+    free(sites);
+    return leakedBytes;
+}
+
+// Function to create a memory stack with the given payload budget
+MemoryStack* createMemoryStackWithCapacity(size_t capacity) {
     MemoryStack* stack = (MemoryStack*)malloc(sizeof(MemoryStack));
     stack->top = NULL;
     stack->totalBlocks = 0;
     stack->totalMemoryUsed = 0;
     stack->maxMemoryUsed = 0;
     stack->nextBlockId = 1001;
+    stack->capacity = capacity;
+    
+    // Reserve enough for the worst case: a budget's worth of one-byte,
+    // cache-line aligned blocks
+    stack->arenaSize = capacity * (getArenaBlockSize(1) + 2 * CACHE_LINE_SIZE);
+    stack->arena = (unsigned char*)malloc(stack->arenaSize);
+    stack->arenaUsed = 0;
+    stack->paddingBytes = 0;
+    stack->virtualArena = 0;
+    stack->releaseToOs = 0;
+    stack->pagesReleased = 0;
+    return stack;
+}
+
+// Function to get the OS page size
+size_t getPageSize() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (size_t)info.dwPageSize;
+#else
+    return (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// Function to create a memory stack over a reserved virtual range. Pages are
+// backed lazily (by the OS on first touch, or committed as the stack top
+// grows on Windows), and an inaccessible guard page after the range turns an
+// overflow into a hardware fault, so allocation skips the budget check. With
+// releaseToOs, popping deep frames returns the freed tail pages with madvise
+// (MEM_DECOMMIT on Windows). NULL on failure.
+MemoryStack* createVirtualMemoryStack(size_t reserveBytes, int releaseToOs) {
+    size_t pageSize = getPageSize();
+    // The guard must be larger than any block, so no block can jump over it
+    size_t guardSize = alignUp(getArenaBlockSize(MAX_BLOCK_SIZE) + 2 * CACHE_LINE_SIZE, pageSize);
+    size_t usable = alignUp(reserveBytes, pageSize);
+    unsigned char* arena;
+    
+#ifdef _WIN32
+    arena = (unsigned char*)VirtualAlloc(NULL, usable + guardSize, MEM_RESERVE, PAGE_NOACCESS);
+    if (arena == NULL) {
+        printf("Error: Cannot reserve %zu bytes of address space\n", usable + guardSize);
+        return NULL;
+    }
+#else
+    arena = (unsigned char*)mmap(NULL, usable + guardSize, PROT_READ | PROT_WRITE,
+                                 MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (arena == MAP_FAILED) {
+        printf("Error: Cannot reserve %zu bytes of address space\n", usable + guardSize);
+        return NULL;
+    }
+    mprotect(arena + usable, guardSize, PROT_NONE);
+#endif
+    
+    MemoryStack* stack = (MemoryStack*)calloc(1, sizeof(MemoryStack));
+    stack->nextBlockId = 1001;
+    stack->capacity = usable;
+    stack->arena = arena;
+    stack->arenaSize = usable + guardSize;
+    stack->virtualArena = 1;
+    stack->pageSize = pageSize;
+    stack->guardOffset = usable;
+    stack->releaseToOs = releaseToOs;
     return stack;
 }
 
+// Function to return whole pages above the stack top to the OS once at
+// least VSTACK_RELEASE_THRESHOLD bytes of them are free
+void releaseVirtualPages(MemoryStack* stack) {
+    if (!stack->virtualArena || !stack->releaseToOs) {
+        return;
+    }
+    
+    size_t keep = alignUp(stack->arenaUsed, stack->pageSize);
+    if (stack->touchedBytes < keep + VSTACK_RELEASE_THRESHOLD) {
+        return;
+    }
+    
+#ifdef _WIN32
+    VirtualFree(stack->arena + keep, stack->touchedBytes - keep, MEM_DECOMMIT);
+#else
+    madvise(stack->arena + keep, stack->touchedBytes - keep, MADV_DONTNEED);
+#endif
+    stack->pagesReleased += (long)((stack->touchedBytes - keep) / stack->pageSize);
+    stack->touchedBytes = keep;
+}
+
+#ifndef _WIN32
+// Guard page trap: the fault handler jumps back here when a guarded
+// allocation is armed, otherwise it reports the overflow and lets it crash
+static MemoryStack* guardedStack = NULL;
+static sigjmp_buf guardRecovery;
+static volatile sig_atomic_t guardArmed = 0;
+
+// Function to handle SIGSEGV/SIGBUS from the guard page
+void guardPageHandler(int signal, siginfo_t* info, void* context) {
+    (void)context;
+    unsigned char* address = (unsigned char*)info->si_addr;
+    MemoryStack* stack = guardedStack;
+    
+    if (stack != NULL && address >= stack->arena + stack->guardOffset &&
+        address < stack->arena + stack->arenaSize) {
+        if (guardArmed) {
+            guardArmed = 0;
+            siglongjmp(guardRecovery, 1);
+        }
+        static const char message[] = "Fatal: virtual stack overflow hit the guard page\n";
+        write(STDERR_FILENO, message, sizeof(message) - 1);
+    }
+    
+    // Not ours (or not recoverable): restore the default action and re-fault
+    struct sigaction action;
+    memset(&action, 0, sizeof(action));
+    action.sa_handler = SIG_DFL;
+    sigaction(signal, &action, NULL);
+}
+
+// Function to install the guard page handler for a virtual stack. An
+// alternate signal stack keeps the handler usable whatever faulted.
+void installGuardPageHandler(MemoryStack* stack) {
+    static unsigned char* alternateStack = NULL;
+    stack_t signalStack;
+    struct sigaction action;
+    
+    if (alternateStack == NULL) {
+        alternateStack = (unsigned char*)malloc(SIGSTKSZ);
+        signalStack.ss_sp = alternateStack;
+        signalStack.ss_size = SIGSTKSZ;
+        signalStack.ss_flags = 0;
+        sigaltstack(&signalStack, NULL);
+    }
+    
+    guardedStack = stack;
+    memset(&action, 0, sizeof(action));
+    action.sa_sigaction = guardPageHandler;
+    action.sa_flags = SA_SIGINFO | SA_ONSTACK;
+    sigemptyset(&action.sa_mask);
+    sigaction(SIGSEGV, &action, NULL);
+    sigaction(SIGBUS, &action, NULL);
+}
+#endif
+
+// Function to create a memory stack
+MemoryStack* createMemoryStack() {
+    return createMemoryStackWithCapacity(MAX_STACK_SIZE);
+}
+
 // Function to check if stack is empty
 int isMemoryStackEmpty(MemoryStack* stack) {
     return stack->top == NULL;
 }
 
-// Function to allocate memory block on stack
-int allocateMemory(MemoryStack* stack, BlockType type, char* varName, size_t size) {
-    if (stack->totalMemoryUsed + size > MAX_STACK_SIZE) {
+// Function to allocate memory block on stack with its payload aligned to
+// alignment (16, 32 or 64); file and line name the caller for the leak
+// tracker (the allocateMemory() macros fill them in)
+int allocateMemoryAlignedAt(MemoryStack* stack, BlockType type, char* varName, size_t size,
+                            size_t alignment, const char* file, int line) {
+    double begin = profileBegin();
+    if (!stack->virtualArena && stack->totalMemoryUsed + size > stack->capacity) {
         printf("Error: Stack overflow! Cannot allocate %zu bytes\n", size);
         return 0;
     }
     
-    MemoryBlock* newBlock = (MemoryBlock*)malloc(sizeof(MemoryBlock));
+    alignment = normalizeAlignment(alignment);
+    if (alignment == 0) {
+        printf("Error: Unsupported alignment! Use 16, 32 or 64\n");
+        return 0;
+    }
+    
+    // The header starts at the bump offset; the payload starts at the next
+    // aligned address after it
+    uintptr_t blockStart = (uintptr_t)(stack->arena + stack->arenaUsed);
+    uintptr_t dataStart = alignUp(blockStart + alignUp(sizeof(MemoryBlock), BLOCK_ALIGNMENT), alignment);
+    size_t blockSize = (size_t)(dataStart - blockStart) + alignUp(size, getPayloadGranularity(alignment));
+    if (stack->virtualArena) {
+#ifdef _WIN32
+        // Windows only reserved the range: commit the pages the top grows
+        // into. Nothing past the guard offset is committed, so a block that
+        // reaches it still faults on the touch below.
+        size_t newTop = stack->arenaUsed + blockSize;
+        if (newTop > stack->touchedBytes && newTop <= stack->guardOffset &&
+            VirtualAlloc(stack->arena + stack->touchedBytes, alignUp(newTop, stack->pageSize) - stack->touchedBytes,
+                         MEM_COMMIT, PAGE_READWRITE) == NULL) {
+            printf("Error: Cannot commit memory for %zu bytes\n", size);
+            return 0;
+        }
+#endif
+        // No bounds check: touch the block's last byte before changing any
+        // state, so a block reaching the guard page faults right here
+        ((volatile unsigned char*)blockStart)[blockSize - 1] = 0;
+        if (stack->arenaUsed + blockSize > stack->touchedBytes) {
+            stack->touchedBytes = alignUp(stack->arenaUsed + blockSize, stack->pageSize);
+        }
+    } else if (stack->arenaUsed + blockSize > stack->arenaSize) {
+        printf("Error: Stack arena exhausted! Cannot allocate %zu bytes\n", size);
+        return 0;
+    }
+    
+    // Bump-allocate the header, with the payload right after it
+    MemoryBlock* newBlock = (MemoryBlock*)(stack->arena + stack->arenaUsed);
     newBlock->blockId = stack->nextBlockId++;
     newBlock->type = type;
     strcpy(newBlock->variableName, varName);
     newBlock->size = size;
     newBlock->allocTime = time(NULL);
+    newBlock->traceId = traceRecordAlloc(size, alignment);
+    newBlock->alignment = alignment;
+    newBlock->padding = blockSize - getArenaBlockSize(size);
     newBlock->next = stack->top;
-    
-    // Allocate actual data space
-    newBlock->data = malloc(size);
-    if (newBlock->data == NULL) {
-        printf("Error: Failed to allocate memory for data\n");
-        free(newBlock);
-        return 0;
+    if (leakTracker != NULL) {
+        leakTrackBlock(leakTracker, newBlock, file, line);
     }
+    newBlock->data = (void*)dataStart;
+    stack->arenaUsed += blockSize;
     
     // Initialize data based on type
     switch (type) {
@@ -114,17 +1199,29 @@ int allocateMemory(MemoryStack* stack, BlockType type, char* varName, size_t siz
     stack->top = newBlock;
     stack->totalBlocks++;
     stack->totalMemoryUsed += size;
+    stack->paddingBytes += newBlock->padding;
     
     if (stack->totalMemoryUsed > stack->maxMemoryUsed) {
         stack->maxMemoryUsed = stack->totalMemoryUsed;
     }
     
+    // Timed before printing so the histogram measures the allocator itself
+    if (allocatorProfile != NULL) {
+        profileBlockType(newBlock, 1);
+        profileEnd(PROFILE_STACK_ALLOC, begin, stack->totalMemoryUsed, stack->totalBlocks);
+    }
+    
     printf("Allocated %zu bytes for %s variable '%s' (Block ID: %d)\n", 
         size, getBlockTypeString(type), varName, newBlock->blockId);
     
     return newBlock->blockId;
 }
 
+#define allocateMemory(stack, type, varName, size) \
+    allocateMemoryAlignedAt(stack, type, varName, size, BLOCK_ALIGNMENT, __FILE__, __LINE__)
+#define allocateMemoryAligned(stack, type, varName, size, alignment) \
+    allocateMemoryAlignedAt(stack, type, varName, size, alignment, __FILE__, __LINE__)
+
 // Function to deallocate top memory block
 int deallocateMemory(MemoryStack* stack) {
     if (isMemoryStackEmpty(stack)) {
@@ -132,6 +1229,7 @@ int deallocateMemory(MemoryStack* stack) {
         return 0;
     }
     
+    double begin = profileBegin();
     MemoryBlock* topBlock = stack->top;
     stack->top = stack->top->next;
     
@@ -141,17 +1239,95 @@ int deallocateMemory(MemoryStack* stack) {
     
     stack->totalBlocks--;
     stack->totalMemoryUsed -= topBlock->size;
+    stack->paddingBytes -= topBlock->padding;
+    traceRecordFree(topBlock->traceId);
+    if (leakTracker != NULL) {
+        leakUntrackBlock(leakTracker, topBlock->blockId);
+    }
+    
+    // Pop by rolling the bump offset back to where this header started
+    // The profile reads the header, so it must run before the header's
+    // page can be handed back to the OS
+    if (allocatorProfile != NULL) {
+        profileBlockType(topBlock, 0);
+    }
+    stack->arenaUsed = (size_t)((unsigned char*)topBlock - stack->arena);
+    releaseVirtualPages(stack);
     
-    free(topBlock->data);
-    free(topBlock);
+    if (allocatorProfile != NULL) {
+        profileEnd(PROFILE_STACK_FREE, begin, stack->totalMemoryUsed, stack->totalBlocks);
+    }
     
     return 1;
 }
 
-// Function to set value in top memory block
-void setTopBlockValue(MemoryStack* stack, void* value) {
-    if (isMemoryStackEmpty(stack)) {
-        printf("Error: No memory block to set value\n");
+// Function to find a live block by id: O(1) through the leak tracker's
+// index when tracking is on (it holds every live block), otherwise a walk
+// down the stack
+MemoryBlock* findMemoryBlock(MemoryStack* stack, int blockId) {
+    if (leakTracker != NULL) {
+        return findTrackedBlock(leakTracker, blockId);
+    }
+    
+    for (MemoryBlock* block = stack->top; block != NULL; block = block->next) {
+        if (block->blockId == blockId) {
+            return block;
+        }
+    }
+    return NULL;
+}
+
+// Function to record a watermark at scope entry
+StackMark markMemoryStack(MemoryStack* stack) {
+    StackMark mark;
+    mark.top = stack->top;
+    mark.arenaUsed = stack->arenaUsed;
+    mark.totalBlocks = stack->totalBlocks;
+    mark.totalMemoryUsed = stack->totalMemoryUsed;
+    mark.paddingBytes = stack->paddingBytes;
+    return mark;
+}
+
+// Function to free every block above a watermark in one operation.
+// The mark holds the exact counters from scope entry, so no block is walked.
+int releaseToMark(MemoryStack* stack, StackMark mark) {
+    if (mark.arenaUsed > stack->arenaUsed) {
+        printf("Error: Mark is above the current stack top (already released?)\n");
+        return 0;
+    }
+    
+    double begin = profileBegin();
+    int releasedBlocks = stack->totalBlocks - mark.totalBlocks;
+    size_t releasedBytes = stack->totalMemoryUsed - mark.totalMemoryUsed;
+    
+    // Only a trace, the leak tracker or the per-type profile needs the
+    // individual frees, so only then are the blocks walked
+    if (traceRecorder != NULL || leakTracker != NULL || allocatorProfile != NULL) {
+        for (MemoryBlock* block = stack->top; block != mark.top; block = block->next) {
+            traceRecordFree(block->traceId);
+            if (leakTracker != NULL) {
+                leakUntrackBlock(leakTracker, block->blockId);
+            }
+            profileBlockType(block, 0);
+        }
+    }
+    
+    stack->top = mark.top;
+    stack->arenaUsed = mark.arenaUsed;
+    stack->totalBlocks = mark.totalBlocks;
+    stack->totalMemoryUsed = mark.totalMemoryUsed;
+    stack->paddingBytes = mark.paddingBytes;
+    releaseVirtualPages(stack);
+    profileEnd(PROFILE_STACK_RELEASE, begin, stack->totalMemoryUsed, stack->totalBlocks);
+    
+    printf("Released %d blocks (%zu bytes) back to the scope mark\n", releasedBlocks, releasedBytes);
+    return releasedBlocks;
+}
+
+// Function to set value in top memory block
+void setTopBlockValue(MemoryStack* stack, void* value) {
+    if (isMemoryStackEmpty(stack)) {
+        printf("Error: No memory block to set value\n");
         return;
     }
     
@@ -253,125 +1429,2402 @@ void displayMemoryStack(MemoryStack* stack) {
         if (position == 1) {
             printf(" <- TOP");
         }
-        printf("\n");
-        
-        current = current->next;
-        position++;
+        printf("\n");
+        
+        current = current->next;
+        position++;
+    }
+    printf("========================================\n\n");
+}
+
+// Function to print the statistics every allocator mode reports
+void printCommonMemoryStats(int totalBlocks, size_t used, size_t maxUsed, size_t capacity) {
+    printf("Total blocks: %d\n", totalBlocks);
+    printf("Memory used: %zu bytes\n", used);
+    printf("Max memory used: %zu bytes\n", maxUsed);
+    printf("Available memory: %zu bytes\n", capacity - used);
+    printf("Memory utilization: %.1f%%\n", (float)used / capacity * 100);
+}
+
+// Function to display memory statistics
+void displayMemoryStats(MemoryStack* stack) {
+    printf("\n=== MEMORY STATISTICS ===\n");
+    printCommonMemoryStats(stack->totalBlocks, stack->totalMemoryUsed, stack->maxMemoryUsed, stack->capacity);
+    printf("Next block ID: %d\n", stack->nextBlockId);
+    printf("Arena used: %zu of %zu bytes (headers included)\n", stack->arenaUsed, stack->arenaSize);
+    printAlignmentPadding(stack->paddingBytes, stack->totalMemoryUsed);
+    if (stack->virtualArena) {
+        printf("Virtual arena: %zu KB reserved, %zu KB touched, guard page at offset %zu\n",
+               stack->guardOffset >> 10, stack->touchedBytes >> 10, stack->guardOffset);
+        printf("Pages returned to the OS: %ld (%s)\n", stack->pagesReleased,
+               stack->releaseToOs ? "release on" : "release off");
+    }
+    printf("=========================\n\n");
+}
+
+// Function to simulate function call with local variables
+void simulateFunctionCall(MemoryStack* stack, char* functionName) {
+    printf("\n=== SIMULATING FUNCTION CALL: %s ===\n", functionName);
+    
+    // Create stack frame marker
+    printf("Creating stack frame for function %s...\n", functionName);
+    StackMark frame = markMemoryStack(stack);
+    
+    // Allocate local variables
+    allocateMemory(stack, BLOCK_INT, "localVar1", sizeof(int));
+    int val1 = 42;
+    setTopBlockValue(stack, &val1);
+    
+    allocateMemory(stack, BLOCK_FLOAT, "localVar2", sizeof(float));
+    float val2 = 3.14f;
+    setTopBlockValue(stack, &val2);
+    
+    allocateMemory(stack, BLOCK_STRING, "message", 50);
+    char msg[] = "Hello from function";
+    setTopBlockValue(stack, msg);
+    
+    printf("Function %s is executing with local variables:\n", functionName);
+    displayMemoryStack(stack);
+    
+    printf("Function %s completed. Cleaning up local variables...\n", functionName);
+    
+    // Clean up local variables (simulate function return) in one step
+    releaseToMark(stack, frame);
+    
+    printf("Stack frame for %s cleaned up.\n", functionName);
+}
+
+// Function to simulate nested function calls
+void simulateNestedCalls(MemoryStack* stack) {
+    printf("\n=== SIMULATING NESTED FUNCTION CALLS ===\n");
+    
+    // Main function variables
+    StackMark mainFrame = markMemoryStack(stack);
+    allocateMemory(stack, BLOCK_INT, "mainVar", sizeof(int));
+    int mainVal = 100;
+    setTopBlockValue(stack, &mainVal);
+    
+    printf("Main function started.\n");
+    displayMemoryStack(stack);
+    
+    // First function call
+    printf("\nCalling function A...\n");
+    StackMark frameA = markMemoryStack(stack);
+    allocateMemory(stack, BLOCK_FLOAT, "functionA_var", sizeof(float));
+    float aVal = 1.5f;
+    setTopBlockValue(stack, &aVal);
+    
+    // Second function call (nested)
+    printf("\nCalling function B from A...\n");
+    StackMark frameB = markMemoryStack(stack);
+    allocateMemory(stack, BLOCK_CHAR, "functionB_var", sizeof(char));
+    char bVal = 'X';
+    setTopBlockValue(stack, &bVal);
+    
+    printf("\nCurrent stack state (nested calls):\n");
+    displayMemoryStack(stack);
+    
+    // Return from function B
+    printf("\nReturning from function B...\n");
+    releaseToMark(stack, frameB);
+    
+    // Return from function A
+    printf("\nReturning from function A...\n");
+    releaseToMark(stack, frameA);
+    
+    printf("\nBack in main function:\n");
+    displayMemoryStack(stack);
+    
+    // Clean up main
+    releaseToMark(stack, mainFrame);
+    printf("\nMain function completed.\n");
+}
+
+// Function to demonstrate memory leak detection
+void demonstrateMemoryLeak(MemoryStack* stack) {
+    printf("\n=== MEMORY LEAK DEMONSTRATION ===\n");
+    
+    printf("Allocating memory without proper cleanup...\n");
+    
+    allocateMemory(stack, BLOCK_ARRAY, "leakyArray1", 50);
+    allocateMemory(stack, BLOCK_STRING, "leakyString", 30);
+    allocateMemory(stack, BLOCK_INT, "leakyInt", sizeof(int));
+    
+    printf("Current memory usage:\n");
+    displayMemoryStats(stack);
+    
+    printf("Simulating program exit without cleanup...\n");
+    printf("Memory leak detected: %zu bytes not freed!\n", stack->totalMemoryUsed);
+    if (leakTracker != NULL) {
+        reportLeaks(leakTracker);
+    } else {
+        printf("(Turn on leak tracking to see which sites allocated them.)\n");
+    }
+    
+    printf("Proper cleanup:\n");
+    while (!isMemoryStackEmpty(stack)) {
+        deallocateMemory(stack);
+    }
+    
+    printf("All memory cleaned up.\n");
+}
+
+// Function to find the size class for a request (-1 if too large)
+int getSlabClass(size_t size) {
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        if (size <= slabClassSizes[i]) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to find the smallest size class that fits size and whose slot
+// size is a multiple of alignment (-1 if none). Slot offsets are multiples
+// of the slot size past a cache-line sized header, so such slots are aligned.
+int getSlabClassAligned(size_t size, size_t alignment) {
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        if (size <= slabClassSizes[i] && slabClassSizes[i] % alignment == 0) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+// Function to get the bytes reserved for the header at the start of each slab
+size_t getSlabHeaderSize() {
+    return alignUp(sizeof(Slab), CACHE_LINE_SIZE);
+}
+
+// Function to create a slab heap over a fixed region of the given size
+SlabHeap* createSlabHeap(size_t size) {
+    SlabHeap* heap = (SlabHeap*)calloc(1, sizeof(SlabHeap));
+    
+    heap->slabCount = (int)(size / SLAB_SIZE);
+    heap->capacity = (size_t)heap->slabCount * SLAB_SIZE;
+    heap->region = (unsigned char*)malloc(heap->capacity + SLAB_SIZE);
+    heap->base = (unsigned char*)alignUp((size_t)(uintptr_t)heap->region, SLAB_SIZE);
+    
+    // Chain every slab onto the free-slab list
+    for (int i = heap->slabCount - 1; i >= 0; i--) {
+        Slab* slab = (Slab*)(heap->base + (size_t)i * SLAB_SIZE);
+        slab->classIndex = -1;
+        slab->heap = heap;
+        slab->next = heap->freeSlabs;
+        heap->freeSlabs = slab;
+    }
+    
+    return heap;
+}
+
+// Function to unlink a slab from its class's partial list
+void unlinkPartialSlab(SlabHeap* heap, Slab* slab) {
+    if (slab->prev != NULL) {
+        slab->prev->next = slab->next;
+    } else {
+        heap->partial[slab->classIndex] = slab->next;
+    }
+    if (slab->next != NULL) {
+        slab->next->prev = slab->prev;
+    }
+    slab->next = slab->prev = NULL;
+}
+
+// Function to push a slab onto its class's partial list
+void linkPartialSlab(SlabHeap* heap, Slab* slab) {
+    slab->prev = NULL;
+    slab->next = heap->partial[slab->classIndex];
+    if (slab->next != NULL) {
+        slab->next->prev = slab;
+    }
+    heap->partial[slab->classIndex] = slab;
+}
+
+// Function to allocate an aligned object from the slab heap
+// (NULL if too large, the alignment is unsupported, or out of slabs)
+void* slabAllocAligned(SlabHeap* heap, size_t size, size_t alignment) {
+    double begin = profileBegin();
+    alignment = normalizeAlignment(alignment);
+    int classIndex = alignment != 0 ? getSlabClassAligned(size, alignment) : -1;
+    if (classIndex < 0) {
+        heap->failedAllocations++;
+        return NULL;
+    }
+    
+    Slab* slab = heap->partial[classIndex];
+    if (slab == NULL) {
+        // Assign a fresh slab to this class
+        slab = heap->freeSlabs;
+        if (slab == NULL) {
+            heap->failedAllocations++;
+            return NULL;
+        }
+        heap->freeSlabs = slab->next;
+        
+        size_t headerSize = getSlabHeaderSize();
+        slab->classIndex = classIndex;
+        slab->freeList = NULL;
+        slab->bumpOffset = headerSize;
+        slab->usedSlots = 0;
+        slab->totalSlots = (int)((SLAB_SIZE - headerSize) / slabClassSizes[classIndex]);
+        linkPartialSlab(heap, slab);
+        heap->slabsInUse[classIndex]++;
+    }
+    
+    void* slot;
+    if (slab->freeList != NULL) {
+        slot = slab->freeList;
+        slab->freeList = *(void**)slot;
+    } else {
+        slot = (unsigned char*)slab + slab->bumpOffset;
+        slab->bumpOffset += slabClassSizes[classIndex];
+    }
+    
+    slab->usedSlots++;
+    if (slab->usedSlots == slab->totalSlots) {
+        unlinkPartialSlab(heap, slab); // Full slabs leave the partial list
+    }
+    
+    heap->totalBlocks++;
+    heap->liveObjects[classIndex]++;
+    heap->totalMemoryUsed += size;
+    heap->slotBytesUsed += slabClassSizes[classIndex];
+    heap->paddingBytes += slabClassSizes[classIndex] - slabClassSizes[getSlabClass(size)];
+    if (heap->totalMemoryUsed > heap->maxMemoryUsed) {
+        heap->maxMemoryUsed = heap->totalMemoryUsed;
+    }
+    
+    profileEnd(PROFILE_SLAB_ALLOC, begin, heap->totalMemoryUsed, heap->totalBlocks);
+    return slot;
+}
+
+// Function to allocate an object from the slab heap (NULL if too large or out of slabs)
+void* slabAlloc(SlabHeap* heap, size_t size) {
+    return slabAllocAligned(heap, size, BLOCK_ALIGNMENT);
+}
+
+// Function to free an object back to its slab, in any order.
+// size must be the size passed to slabAlloc (it keeps the statistics exact).
+void slabFree(SlabHeap* heap, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+    
+    double begin = profileBegin();
+    Slab* slab = (Slab*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+    int classIndex = slab->classIndex;
+    
+    *(void**)ptr = slab->freeList;
+    slab->freeList = ptr;
+    
+    if (slab->usedSlots == slab->totalSlots) {
+        linkPartialSlab(heap, slab); // Was full, has room again
+    }
+    slab->usedSlots--;
+    
+    heap->totalBlocks--;
+    heap->liveObjects[classIndex]--;
+    heap->totalMemoryUsed -= size;
+    heap->slotBytesUsed -= slabClassSizes[classIndex];
+    heap->paddingBytes -= slabClassSizes[classIndex] - slabClassSizes[getSlabClass(size)];
+    
+    // Return empty slabs so any class can reuse them
+    if (slab->usedSlots == 0) {
+        unlinkPartialSlab(heap, slab);
+        heap->slabsInUse[classIndex]--;
+        slab->classIndex = -1;
+        slab->next = heap->freeSlabs;
+        heap->freeSlabs = slab;
+    }
+    
+    profileEnd(PROFILE_SLAB_FREE, begin, heap->totalMemoryUsed, heap->totalBlocks);
+}
+
+// Function to free a slab heap and its region
+void freeSlabHeap(SlabHeap* heap) {
+    free(heap->region);
+    free(heap);
+}
+
+// Function to display slab heap statistics
+void displaySlabHeapStats(SlabHeap* heap) {
+    int slabsInUse = 0, usedSlots = 0, totalSlots = 0;
+    size_t headerSize = getSlabHeaderSize();
+    
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        int slotsPerSlab = (int)((SLAB_SIZE - headerSize) / slabClassSizes[i]);
+        slabsInUse += heap->slabsInUse[i];
+        usedSlots += heap->liveObjects[i];
+        totalSlots += heap->slabsInUse[i] * slotsPerSlab;
+    }
+    
+    printf("\n=== SLAB HEAP STATISTICS ===\n");
+    printCommonMemoryStats(heap->totalBlocks, heap->totalMemoryUsed, heap->maxMemoryUsed, heap->capacity);
+    printf("Slabs in use: %d of %d (%d bytes each)\n", slabsInUse, heap->slabCount, SLAB_SIZE);
+    printf("Slab utilization: %.1f%% (%d of %d slots)\n",
+           totalSlots > 0 ? (float)usedSlots / totalSlots * 100 : 0.0f, usedSlots, totalSlots);
+    printf("Internal fragmentation: %.1f%% (%zu bytes of class rounding)\n",
+           heap->slotBytesUsed > 0 ?
+           (float)(heap->slotBytesUsed - heap->totalMemoryUsed) / heap->slotBytesUsed * 100 : 0.0f,
+           heap->slotBytesUsed - heap->totalMemoryUsed);
+    printf("External fragmentation: %.1f%% (free slots stranded in partial slabs)\n",
+           totalSlots > 0 ? (float)(totalSlots - usedSlots) / totalSlots * 100 : 0.0f);
+    printAlignmentPadding(heap->paddingBytes, heap->totalMemoryUsed);
+    printf("Failed allocations: %ld\n", heap->failedAllocations);
+    
+    printf("%-8s %-8s %-8s %-12s\n", "Class", "Slabs", "Live", "Utilization");
+    for (int i = 0; i < SLAB_CLASS_COUNT; i++) {
+        if (heap->slabsInUse[i] > 0) {
+            int slotsPerSlab = (int)((SLAB_SIZE - headerSize) / slabClassSizes[i]);
+            printf("%-8zu %-8d %-8d %.1f%%\n", slabClassSizes[i], heap->slabsInUse[i], heap->liveObjects[i],
+                   (float)heap->liveObjects[i] / (heap->slabsInUse[i] * slotsPerSlab) * 100);
+        }
+    }
+    printf("============================\n\n");
+}
+
+// Function to demonstrate out-of-order frees in the slab heap
+void demonstrateSlabHeap(SlabHeap* heap) {
+    size_t sizes[] = {sizeof(int), 24, 100, 7, 300, sizeof(float), 64, 1000};
+    int count = sizeof(sizes) / sizeof(sizes[0]);
+    void* objects[8];
+    
+    printf("\n=== SLAB HEAP DEMONSTRATION ===\n");
+    for (int i = 0; i < count; i++) {
+        objects[i] = slabAlloc(heap, sizes[i]);
+        printf("Allocated %zu bytes in the %zu-byte class at %p\n",
+               sizes[i], slabClassSizes[getSlabClass(sizes[i])], objects[i]);
+    }
+    displaySlabHeapStats(heap);
+    
+    // Free every other object first, then the rest - not in LIFO order
+    printf("Freeing objects out of order...\n");
+    for (int i = 0; i < count; i += 2) {
+        slabFree(heap, objects[i], sizes[i]);
+        printf("Freed %zu-byte object at %p\n", sizes[i], objects[i]);
+    }
+    displaySlabHeapStats(heap);
+    
+    for (int i = 1; i < count; i += 2) {
+        slabFree(heap, objects[i], sizes[i]);
+    }
+    printf("Remaining objects freed; every slab returned to the free list.\n");
+}
+
+// Function to create a buddy allocator; the capacity is rounded up to a power of two
+BuddyAllocator* createBuddyAllocator(size_t capacity) {
+    BuddyAllocator* buddy = (BuddyAllocator*)calloc(1, sizeof(BuddyAllocator));
+    unsigned int order = BUDDY_MIN_ORDER;
+    
+    while (((size_t)1 << order) < capacity && order < BUDDY_MAX_ORDER) {
+        order++;
+    }
+    
+    buddy->maxOrder = order;
+    buddy->capacity = (size_t)1 << order;
+    buddy->rawRegion = (unsigned char*)malloc(buddy->capacity + CACHE_LINE_SIZE);
+    buddy->region = (unsigned char*)alignUp((size_t)(uintptr_t)buddy->rawRegion, CACHE_LINE_SIZE);
+    
+    // The whole region starts as one free block of the top order
+    BuddyBlock* block = (BuddyBlock*)buddy->region;
+    block->order = order;
+    block->isFree = 1;
+    block->next = block->prev = NULL;
+    buddy->freeLists[order] = block;
+    buddy->freeCounts[order] = 1;
+    
+    return buddy;
+}
+
+// Function to push a free block onto the list for its order
+void pushBuddyFree(BuddyAllocator* buddy, BuddyBlock* block) {
+    block->isFree = 1;
+    block->prev = NULL;
+    block->next = buddy->freeLists[block->order];
+    if (block->next != NULL) {
+        block->next->prev = block;
+    }
+    buddy->freeLists[block->order] = block;
+    buddy->freeCounts[block->order]++;
+}
+
+// Function to unlink a free block from the list for its order
+void removeBuddyFree(BuddyAllocator* buddy, BuddyBlock* block) {
+    if (block->prev != NULL) {
+        block->prev->next = block->next;
+    } else {
+        buddy->freeLists[block->order] = block->next;
+    }
+    if (block->next != NULL) {
+        block->next->prev = block->prev;
+    }
+    block->isFree = 0;
+    buddy->freeCounts[block->order]--;
+}
+
+// Function to allocate an aligned payload from the buddy allocator in
+// O(log n): find the smallest free order that fits, then split it down.
+// Blocks sit at multiples of their size in a cache-line aligned region,
+// so any block larger than the alignment starts aligned.
+void* buddyAllocAligned(BuddyAllocator* buddy, size_t size, size_t alignment) {
+    double begin = profileBegin();
+    unsigned int order = BUDDY_MIN_ORDER;
+    
+    alignment = normalizeAlignment(alignment);
+    if (alignment == 0) {
+        buddy->failedAllocations++;
+        return NULL;
+    }
+    size_t payloadOffset = alignUp(BUDDY_HEADER_SIZE, alignment);
+    
+    while (((size_t)1 << order) < size + payloadOffset && order <= buddy->maxOrder) {
+        order++;
+    }
+    
+    unsigned int available = order;
+    while (available <= buddy->maxOrder && buddy->freeLists[available] == NULL) {
+        available++;
+    }
+    if (available > buddy->maxOrder) {
+        buddy->failedAllocations++;
+        return NULL;
+    }
+    
+    BuddyBlock* block = buddy->freeLists[available];
+    removeBuddyFree(buddy, block);
+    
+    // Split, keeping the lower half and freeing the upper half each time
+    while (available > order) {
+        available--;
+        BuddyBlock* half = (BuddyBlock*)((unsigned char*)block + ((size_t)1 << available));
+        half->order = available;
+        pushBuddyFree(buddy, half);
+    }
+    
+    block->order = order;
+    block->isFree = 0;
+    block->payloadOffset = (unsigned short)payloadOffset;
+    block->requested = size;
+    if (payloadOffset > BUDDY_HEADER_SIZE) {
+        memcpy((unsigned char*)block + payloadOffset - BUDDY_HEADER_SIZE, block, BUDDY_HEADER_SIZE);
+    }
+    
+    buddy->totalBlocks++;
+    buddy->totalMemoryUsed += size;
+    buddy->blockBytesUsed += (size_t)1 << order;
+    buddy->paddingBytes += payloadOffset - BUDDY_HEADER_SIZE;
+    if (buddy->totalMemoryUsed > buddy->maxMemoryUsed) {
+        buddy->maxMemoryUsed = buddy->totalMemoryUsed;
+    }
+    if (buddy->blockBytesUsed > buddy->highWaterMark) {
+        buddy->highWaterMark = buddy->blockBytesUsed;
+    }
+    
+    profileEnd(PROFILE_BUDDY_ALLOC, begin, buddy->totalMemoryUsed, buddy->totalBlocks);
+    return (unsigned char*)block + payloadOffset;
+}
+
+// Function to allocate from the buddy allocator with the default alignment
+void* buddyAlloc(BuddyAllocator* buddy, size_t size) {
+    return buddyAllocAligned(buddy, size, BLOCK_ALIGNMENT);
+}
+
+// Function to free a buddy block, coalescing with free buddies in O(log n)
+void buddyFree(BuddyAllocator* buddy, void* ptr) {
+    if (ptr == NULL) {
+        return;
+    }
+    
+    double begin = profileBegin();
+    BuddyBlock* header = (BuddyBlock*)((unsigned char*)ptr - BUDDY_HEADER_SIZE);
+    BuddyBlock* block = (BuddyBlock*)((unsigned char*)ptr - header->payloadOffset);
+    
+    buddy->totalBlocks--;
+    buddy->paddingBytes -= block->payloadOffset - BUDDY_HEADER_SIZE;
+    buddy->totalMemoryUsed -= block->requested;
+    buddy->blockBytesUsed -= (size_t)1 << block->order;
+    
+    while (block->order < buddy->maxOrder) {
+        size_t offset = (size_t)((unsigned char*)block - buddy->region);
+        BuddyBlock* partner = (BuddyBlock*)(buddy->region + (offset ^ ((size_t)1 << block->order)));
+        
+        if (!partner->isFree || partner->order != block->order) {
+            break;
+        }
+        
+        // Merge: the lower address becomes the header of the combined block
+        removeBuddyFree(buddy, partner);
+        if (partner < block) {
+            block = partner;
+        }
+        block->order++;
+    }
+    
+    pushBuddyFree(buddy, block);
+    profileEnd(PROFILE_BUDDY_FREE, begin, buddy->totalMemoryUsed, buddy->totalBlocks);
+}
+
+// Function to get the largest free buddy block in bytes (0 if none)
+size_t getLargestBuddyFree(BuddyAllocator* buddy) {
+    for (int order = (int)buddy->maxOrder; order >= BUDDY_MIN_ORDER; order--) {
+        if (buddy->freeLists[order] != NULL) {
+            return (size_t)1 << order;
+        }
+    }
+    return 0;
+}
+
+// Function to free a buddy allocator and its region
+void freeBuddyAllocator(BuddyAllocator* buddy) {
+    free(buddy->rawRegion);
+    free(buddy);
+}
+
+// Function to display buddy allocator statistics
+void displayBuddyStats(BuddyAllocator* buddy) {
+    size_t freeBytes = buddy->capacity - buddy->blockBytesUsed;
+    size_t largestFree = getLargestBuddyFree(buddy);
+    
+    printf("\n=== BUDDY ALLOCATOR STATISTICS ===\n");
+    printCommonMemoryStats(buddy->totalBlocks, buddy->totalMemoryUsed, buddy->maxMemoryUsed, buddy->capacity);
+    printf("Block bytes in use: %zu (high-water mark %zu)\n", buddy->blockBytesUsed, buddy->highWaterMark);
+    printf("Largest free block: %zu bytes\n", largestFree);
+    printf("Internal fragmentation: %.1f%% (%zu bytes of headers and power-of-two rounding)\n",
+           buddy->blockBytesUsed > 0 ?
+           (float)(buddy->blockBytesUsed - buddy->totalMemoryUsed) / buddy->blockBytesUsed * 100 : 0.0f,
+           buddy->blockBytesUsed - buddy->totalMemoryUsed);
+    printf("External fragmentation: %.1f%% (free bytes outside the largest free block)\n",
+           freeBytes > 0 ? (float)(freeBytes - largestFree) / freeBytes * 100 : 0.0f);
+    printAlignmentPadding(buddy->paddingBytes, buddy->totalMemoryUsed);
+    printf("Failed allocations: %ld\n", buddy->failedAllocations);
+    printf("Free blocks by size:");
+    for (unsigned int order = BUDDY_MIN_ORDER; order <= buddy->maxOrder; order++) {
+        if (buddy->freeCounts[order] > 0) {
+            printf(" %zux%d", (size_t)1 << order, buddy->freeCounts[order]);
+        }
+    }
+    printf("\n==================================\n\n");
+}
+
+// Function to demonstrate buddy splitting and coalescing
+void demonstrateBuddyAllocator(BuddyAllocator* buddy) {
+    size_t sizes[] = {sizeof(int), 24, 100, 60, 200};
+    int count = sizeof(sizes) / sizeof(sizes[0]);
+    void* blocks[5];
+    
+    printf("\n=== BUDDY ALLOCATOR DEMONSTRATION ===\n");
+    printf("Region: %zu bytes, smallest block %d bytes\n", buddy->capacity, 1 << BUDDY_MIN_ORDER);
+    for (int i = 0; i < count; i++) {
+        blocks[i] = buddyAlloc(buddy, sizes[i]);
+        if (blocks[i] != NULL) {
+            BuddyBlock* block = (BuddyBlock*)((unsigned char*)blocks[i] - BUDDY_HEADER_SIZE);
+            printf("Allocated %zu bytes in a %zu-byte block at offset %zu\n", sizes[i],
+                   (size_t)1 << block->order, (size_t)((unsigned char*)block - buddy->region));
+        } else {
+            printf("Could not allocate %zu bytes: no free block large enough\n", sizes[i]);
+        }
+    }
+    displayBuddyStats(buddy);
+    
+    printf("Freeing the 24-byte and 60-byte blocks (holes between live blocks)...\n");
+    buddyFree(buddy, blocks[1]);
+    buddyFree(buddy, blocks[3]);
+    displayBuddyStats(buddy);
+    
+    printf("Freeing the rest; buddies coalesce back into one block...\n");
+    buddyFree(buddy, blocks[0]);
+    buddyFree(buddy, blocks[2]);
+    buddyFree(buddy, blocks[4]);
+    displayBuddyStats(buddy);
+}
+
+// Function to get a TLSF block's payload size without the flag bit
+size_t getTlsfSize(TlsfBlock* block) {
+    return block->size & ~TLSF_FREE_BIT;
+}
+
+// Function to get the block physically after a TLSF block
+TlsfBlock* getNextPhysBlock(TlsfBlock* block) {
+    return (TlsfBlock*)((unsigned char*)block + TLSF_HEADER_SIZE + getTlsfSize(block));
+}
+
+// Function to map a block size to its free list (first and second level)
+void mapTlsfSize(size_t size, int* fl, int* sl) {
+    if (size < TLSF_SMALL_BLOCK) {
+        *fl = 0;
+        *sl = (int)(size / (TLSF_SMALL_BLOCK / TLSF_SL_COUNT));
+    } else {
+        int msb = 63 - __builtin_clzll((unsigned long long)size);
+        *sl = (int)((size >> (msb - TLSF_SL_LOG2)) - TLSF_SL_COUNT);
+        *fl = msb - (TLSF_FL_SHIFT - 1);
+    }
+}
+
+// Function to insert a free block at the head of its list and set its bits
+void insertTlsfFree(TlsfAllocator* tlsf, TlsfBlock* block) {
+    int fl, sl;
+    mapTlsfSize(getTlsfSize(block), &fl, &sl);
+    
+    block->size |= TLSF_FREE_BIT;
+    block->prevFree = NULL;
+    block->nextFree = tlsf->freeLists[fl][sl];
+    if (block->nextFree != NULL) {
+        block->nextFree->prevFree = block;
+    }
+    tlsf->freeLists[fl][sl] = block;
+    tlsf->flBitmap |= 1ULL << fl;
+    tlsf->slBitmap[fl] |= 1U << sl;
+    tlsf->freeBlocks++;
+}
+
+// Function to unlink a free block from its list, clearing bits of empty lists
+void removeTlsfFree(TlsfAllocator* tlsf, TlsfBlock* block) {
+    int fl, sl;
+    mapTlsfSize(getTlsfSize(block), &fl, &sl);
+    
+    if (block->prevFree != NULL) {
+        block->prevFree->nextFree = block->nextFree;
+    } else {
+        tlsf->freeLists[fl][sl] = block->nextFree;
+        if (block->nextFree == NULL) {
+            tlsf->slBitmap[fl] &= ~(1U << sl);
+            if (tlsf->slBitmap[fl] == 0) {
+                tlsf->flBitmap &= ~(1ULL << fl);
+            }
+        }
+    }
+    if (block->nextFree != NULL) {
+        block->nextFree->prevFree = block->prevFree;
+    }
+    block->size &= ~TLSF_FREE_BIT;
+    tlsf->freeBlocks--;
+}
+
+// Function to create a TLSF allocator: one free block spanning the region
+// and a zero-sized, never-free sentinel at the end
+TlsfAllocator* createTlsfAllocator(size_t capacity) {
+    TlsfAllocator* tlsf = (TlsfAllocator*)calloc(1, sizeof(TlsfAllocator));
+    
+    tlsf->capacity = alignUp(capacity < 4 * TLSF_HEADER_SIZE ? 4 * TLSF_HEADER_SIZE : capacity, BLOCK_ALIGNMENT);
+    tlsf->rawRegion = (unsigned char*)malloc(tlsf->capacity + CACHE_LINE_SIZE);
+    tlsf->region = (unsigned char*)alignUp((size_t)(uintptr_t)tlsf->rawRegion, CACHE_LINE_SIZE);
+    
+    TlsfBlock* block = (TlsfBlock*)tlsf->region;
+    block->prevPhys = NULL;
+    block->size = tlsf->capacity - 2 * TLSF_HEADER_SIZE;
+    insertTlsfFree(tlsf, block);
+    
+    TlsfBlock* sentinel = getNextPhysBlock(block);
+    sentinel->prevPhys = block;
+    sentinel->size = 0;
+    
+    return tlsf;
+}
+
+// Function to free a TLSF allocator and its region
+void freeTlsfAllocator(TlsfAllocator* tlsf) {
+    free(tlsf->rawRegion);
+    free(tlsf);
+}
+
+// Function to split a block so it keeps payload bytes, returning the
+// remainder to the free lists when it can hold a minimum block
+void splitTlsfBlock(TlsfAllocator* tlsf, TlsfBlock* block, size_t payload) {
+    size_t size = getTlsfSize(block);
+    if (size < payload + TLSF_HEADER_SIZE + TLSF_MIN_PAYLOAD) {
+        return;
+    }
+    
+    TlsfBlock* rest = (TlsfBlock*)((unsigned char*)block + TLSF_HEADER_SIZE + payload);
+    rest->prevPhys = block;
+    rest->size = size - payload - TLSF_HEADER_SIZE;
+    getNextPhysBlock(rest)->prevPhys = rest;
+    block->size = payload | (block->size & TLSF_FREE_BIT);
+    insertTlsfFree(tlsf, rest);
+}
+
+// Function to allocate an aligned payload in O(1): round the request up to
+// the next list boundary so any block found there fits, take the first
+// non-empty list at or above it from the bitmaps, and split off the rest
+void* tlsfAllocAligned(TlsfAllocator* tlsf, size_t size, size_t alignment) {
+    double begin = profileBegin();
+    alignment = normalizeAlignment(alignment);
+    size_t payload = alignUp(size > 0 ? size : 1, BLOCK_ALIGNMENT);
+    if (payload < TLSF_MIN_PAYLOAD) {
+        payload = TLSF_MIN_PAYLOAD;
+    }
+    
+    // Room for a leading gap that becomes its own free block
+    size_t searchSize = payload + (alignment > BLOCK_ALIGNMENT ? alignment + TLSF_HEADER_SIZE : 0);
+    if (alignment == 0 || searchSize >= tlsf->capacity) {
+        tlsf->failedAllocations++;
+        return NULL;
+    }
+    if (searchSize >= TLSF_SMALL_BLOCK) {
+        searchSize += ((size_t)1 << (63 - __builtin_clzll((unsigned long long)searchSize) - TLSF_SL_LOG2)) - 1;
+    }
+    
+    int fl, sl;
+    mapTlsfSize(searchSize, &fl, &sl);
+    unsigned int slMap = fl < TLSF_FL_COUNT ? tlsf->slBitmap[fl] & (~0U << sl) : 0;
+    if (slMap == 0) {
+        unsigned long long flMap = fl + 1 < TLSF_FL_COUNT ? tlsf->flBitmap & (~0ULL << (fl + 1)) : 0;
+        if (flMap == 0) {
+            tlsf->failedAllocations++;
+            return NULL;
+        }
+        fl = __builtin_ctzll(flMap);
+        slMap = tlsf->slBitmap[fl];
+    }
+    sl = __builtin_ctz(slMap);
+    
+    TlsfBlock* block = tlsf->freeLists[fl][sl];
+    removeTlsfFree(tlsf, block);
+    
+    if (alignment > BLOCK_ALIGNMENT) {
+        uintptr_t start = (uintptr_t)block + TLSF_HEADER_SIZE;
+        uintptr_t aligned = alignUp(start, alignment);
+        // A leading gap must hold a whole minimum block
+        if (aligned != start && aligned - start < TLSF_HEADER_SIZE + TLSF_MIN_PAYLOAD) {
+            aligned += alignment;
+        }
+        if (aligned != start) {
+            size_t gap = (size_t)(aligned - start);
+            TlsfBlock* alignedBlock = (TlsfBlock*)(aligned - TLSF_HEADER_SIZE);
+            alignedBlock->prevPhys = block;
+            alignedBlock->size = getTlsfSize(block) - gap;
+            getNextPhysBlock(alignedBlock)->prevPhys = alignedBlock;
+            block->size = gap - TLSF_HEADER_SIZE;
+            insertTlsfFree(tlsf, block); // Its neighbours are in use, so no merge is needed
+            block = alignedBlock;
+        }
+    }
+    splitTlsfBlock(tlsf, block, payload);
+    
+    tlsf->totalBlocks++;
+    tlsf->totalMemoryUsed += size;
+    tlsf->blockBytesUsed += TLSF_HEADER_SIZE + getTlsfSize(block);
+    if (tlsf->totalMemoryUsed > tlsf->maxMemoryUsed) {
+        tlsf->maxMemoryUsed = tlsf->totalMemoryUsed;
+    }
+    if (tlsf->blockBytesUsed > tlsf->highWaterMark) {
+        tlsf->highWaterMark = tlsf->blockBytesUsed;
+    }
+    
+    profileEnd(PROFILE_TLSF_ALLOC, begin, tlsf->totalMemoryUsed, tlsf->totalBlocks);
+    return (unsigned char*)block + TLSF_HEADER_SIZE;
+}
+
+// Function to allocate from the TLSF allocator with the default alignment
+void* tlsfAlloc(TlsfAllocator* tlsf, size_t size) {
+    return tlsfAllocAligned(tlsf, size, BLOCK_ALIGNMENT);
+}
+
+// Function to free a TLSF block in O(1), merging at once with free
+// physical neighbours. size must be the size passed to tlsfAlloc.
+void tlsfFree(TlsfAllocator* tlsf, void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+    
+    double begin = profileBegin();
+    TlsfBlock* block = (TlsfBlock*)((unsigned char*)ptr - TLSF_HEADER_SIZE);
+    
+    tlsf->totalBlocks--;
+    tlsf->totalMemoryUsed -= size;
+    tlsf->blockBytesUsed -= TLSF_HEADER_SIZE + getTlsfSize(block);
+    
+    TlsfBlock* prev = block->prevPhys;
+    if (prev != NULL && (prev->size & TLSF_FREE_BIT)) {
+        removeTlsfFree(tlsf, prev);
+        prev->size += TLSF_HEADER_SIZE + getTlsfSize(block);
+        block = prev;
+        getNextPhysBlock(block)->prevPhys = block;
+    }
+    
+    TlsfBlock* next = getNextPhysBlock(block);
+    if (next->size & TLSF_FREE_BIT) {
+        removeTlsfFree(tlsf, next);
+        block->size += TLSF_HEADER_SIZE + getTlsfSize(next);
+        getNextPhysBlock(block)->prevPhys = block;
+    }
+    
+    insertTlsfFree(tlsf, block);
+    profileEnd(PROFILE_TLSF_FREE, begin, tlsf->totalMemoryUsed, tlsf->totalBlocks);
+}
+
+// Function to get the largest free TLSF block payload (0 if none). The
+// highest non-empty list holds it; that one list is scanned.
+size_t getLargestTlsfFree(TlsfAllocator* tlsf) {
+    if (tlsf->flBitmap == 0) {
+        return 0;
+    }
+    
+    int fl = 63 - __builtin_clzll(tlsf->flBitmap);
+    int sl = 31 - __builtin_clz(tlsf->slBitmap[fl]);
+    size_t largest = 0;
+    for (TlsfBlock* block = tlsf->freeLists[fl][sl]; block != NULL; block = block->nextFree) {
+        if (getTlsfSize(block) > largest) {
+            largest = getTlsfSize(block);
+        }
+    }
+    return largest;
+}
+
+// Function to display TLSF allocator statistics
+void displayTlsfStats(TlsfAllocator* tlsf) {
+    size_t freeBytes = tlsf->capacity - tlsf->blockBytesUsed - TLSF_HEADER_SIZE; // Sentinel excluded
+    size_t largestFree = getLargestTlsfFree(tlsf);
+    size_t usableFree = freeBytes - (size_t)tlsf->freeBlocks * TLSF_HEADER_SIZE;
+    
+    printf("\n=== TLSF ALLOCATOR STATISTICS ===\n");
+    printCommonMemoryStats(tlsf->totalBlocks, tlsf->totalMemoryUsed, tlsf->maxMemoryUsed, tlsf->capacity);
+    printf("Block bytes in use: %zu (high-water mark %zu)\n", tlsf->blockBytesUsed, tlsf->highWaterMark);
+    printf("Free blocks: %d, largest %zu bytes\n", tlsf->freeBlocks, largestFree);
+    printf("Internal fragmentation: %.1f%% (%zu bytes of headers and 16-byte rounding)\n",
+           tlsf->blockBytesUsed > 0 ?
+           (float)(tlsf->blockBytesUsed - tlsf->totalMemoryUsed) / tlsf->blockBytesUsed * 100 : 0.0f,
+           tlsf->blockBytesUsed - tlsf->totalMemoryUsed);
+    printf("External fragmentation: %.1f%% (free bytes outside the largest free block)\n",
+           usableFree > 0 ? (float)(usableFree - largestFree) / usableFree * 100 : 0.0f);
+    printf("Failed allocations: %ld\n", tlsf->failedAllocations);
+    printf("=================================\n\n");
+}
+
+// Function to demonstrate TLSF splitting and immediate coalescing
+void demonstrateTlsfAllocator(TlsfAllocator* tlsf) {
+    size_t sizes[] = {sizeof(int), 24, 100, 60, 200, 1000};
+    int count = sizeof(sizes) / sizeof(sizes[0]);
+    void* blocks[6];
+    
+    printf("\n=== TLSF ALLOCATOR DEMONSTRATION ===\n");
+    for (int i = 0; i < count; i++) {
+        blocks[i] = tlsfAlloc(tlsf, sizes[i]);
+        if (blocks[i] != NULL) {
+            int fl, sl;
+            size_t blockSize = getTlsfSize((TlsfBlock*)((unsigned char*)blocks[i] - TLSF_HEADER_SIZE));
+            mapTlsfSize(blockSize, &fl, &sl);
+            printf("Allocated %zu bytes in a %zu-byte block (list %d/%d) at offset %zu\n", sizes[i], blockSize,
+                   fl, sl, (size_t)((unsigned char*)blocks[i] - tlsf->region));
+        } else {
+            printf("Could not allocate %zu bytes\n", sizes[i]);
+        }
+    }
+    displayTlsfStats(tlsf);
+    
+    printf("Freeing the 24, 60 and 1000-byte blocks (the last merges with the free tail)...\n");
+    tlsfFree(tlsf, blocks[1], sizes[1]);
+    tlsfFree(tlsf, blocks[3], sizes[3]);
+    tlsfFree(tlsf, blocks[5], sizes[5]);
+    displayTlsfStats(tlsf);
+    
+    printf("Freeing the rest; neighbours merge immediately into one block...\n");
+    tlsfFree(tlsf, blocks[0], sizes[0]);
+    tlsfFree(tlsf, blocks[2], sizes[2]);
+    tlsfFree(tlsf, blocks[4], sizes[4]);
+    displayTlsfStats(tlsf);
+}
+
+// Function to grow the handle table to the given capacity and put the new
+// handles on the unused list, lowest first (handle 0 is never handed out)
+void growCompactHandles(CompactingHeap* heap, unsigned int capacity) {
+    unsigned int oldCapacity = heap->handleCapacity;
+    heap->handles = (CompactSlot*)realloc(heap->handles, capacity * sizeof(CompactSlot));
+    memset(heap->handles + oldCapacity, 0, (capacity - oldCapacity) * sizeof(CompactSlot));
+    heap->handleCapacity = capacity;
+    
+    for (unsigned int h = capacity - 1; h >= (oldCapacity > 0 ? oldCapacity : 1); h--) {
+        heap->handles[h].nextFree = heap->freeHandle;
+        heap->freeHandle = h;
+    }
+}
+
+// Function to create a compacting heap over a fixed region of the given size
+CompactingHeap* createCompactingHeap(size_t capacity) {
+    CompactingHeap* heap = (CompactingHeap*)calloc(1, sizeof(CompactingHeap));
+    
+    heap->capacity = alignUp(capacity < 4 * COMPACT_HEADER_SIZE ? 4 * COMPACT_HEADER_SIZE : capacity, BLOCK_ALIGNMENT);
+    heap->rawRegion = (unsigned char*)malloc(heap->capacity + CACHE_LINE_SIZE);
+    heap->region = (unsigned char*)alignUp((size_t)(uintptr_t)heap->rawRegion, CACHE_LINE_SIZE);
+    heap->firstDead = heap->capacity;
+    heap->pauses.minNs = ~0ULL;
+    growCompactHandles(heap, COMPACT_HANDLE_INITIAL);
+    
+    return heap;
+}
+
+// Function to free a compacting heap, its region and its handle table
+void freeCompactingHeap(CompactingHeap* heap) {
+    free(heap->handles);
+    free(heap->rawRegion);
+    free(heap);
+}
+
+// Function to get the header of the block at an offset of the region
+CompactHeader* getCompactHeader(CompactingHeap* heap, size_t offset) {
+    return (CompactHeader*)(heap->region + offset);
+}
+
+// Function to run the compactor for at most sliceNs nanoseconds (0 runs the
+// cycle to the end). A cycle starts at the first dead block; live blocks
+// after it are slid down over dead ones in address order and their handles
+// updated. Returns 1 when a cycle finished.
+int compactStep(CompactingHeap* heap, double sliceNs) {
+    if (!heap->compacting) {
+        if (heap->deadBytes == 0) {
+            return 0;
+        }
+        heap->compacting = 1;
+        heap->compactScan = heap->firstDead;
+        heap->compactWrite = heap->firstDead;
+        heap->firstDead = heap->capacity;
+    }
+    
+    double begin = currentTimeNs();
+    while (heap->compactScan < heap->top) {
+        CompactHeader* header = getCompactHeader(heap, heap->compactScan);
+        size_t blockBytes = COMPACT_HEADER_SIZE + header->size;
+        
+        if (header->handle != 0) {
+            if (heap->compactScan != heap->compactWrite) {
+                heap->handles[header->handle].offset = heap->compactWrite + COMPACT_HEADER_SIZE;
+                memmove(heap->region + heap->compactWrite, header, blockBytes);
+                heap->bytesMoved += blockBytes;
+            }
+            heap->compactWrite += blockBytes;
+        }
+        heap->compactScan += blockBytes;
+        
+        if (sliceNs > 0 && currentTimeNs() - begin >= sliceNs) {
+            break;
+        }
+    }
+    
+    int finished = heap->compactScan >= heap->top;
+    if (finished) {
+        // Blocks freed behind the write cursor during the cycle stay dead
+        size_t reclaimed = heap->top - heap->compactWrite;
+        heap->deadBytes -= reclaimed;
+        heap->bytesReclaimed += reclaimed;
+        heap->top = heap->compactWrite;
+        heap->compacting = 0;
+        heap->cycles++;
+    }
+    
+    if (sliceNs > 0) {
+        heap->slices++;
+    } else {
+        heap->fullCompactions++;
+    }
+    recordLatency(&heap->pauses, (unsigned long long)(currentTimeNs() - begin));
+    return finished;
+}
+
+// Function to run one compaction slice if a cycle is running or the dead
+// bytes have reached the trigger; returns 1 when a cycle finished
+int compactIfNeeded(CompactingHeap* heap, double sliceNs) {
+    if (!heap->compacting && heap->deadBytes * COMPACT_DEAD_TRIGGER < heap->top) {
+        return 0;
+    }
+    return compactStep(heap, sliceNs);
+}
+
+// Function to allocate a block and return its handle (0 on failure). When the
+// free tail is too small but dead blocks would make room, the current cycle
+// is finished at once (a full pause) before giving up.
+MemoryHandle compactAlloc(CompactingHeap* heap, size_t size) {
+    double begin = profileBegin();
+    size_t blockBytes = COMPACT_HEADER_SIZE + alignUp(size > 0 ? size : 1, BLOCK_ALIGNMENT);
+    
+    if (size > 0xFFFFFFFFU || blockBytes > heap->capacity - heap->top) {
+        if (size > 0xFFFFFFFFU || blockBytes > heap->capacity - heap->top + heap->deadBytes) {
+            heap->failedAllocations++;
+            return 0;
+        }
+        // A cycle already in progress leaves blocks freed behind its cursor,
+        // so a second full cycle may be needed
+        while (blockBytes > heap->capacity - heap->top && heap->deadBytes > 0) {
+            compactStep(heap, 0);
+        }
+    }
+    
+    if (heap->freeHandle == 0) {
+        growCompactHandles(heap, heap->handleCapacity * 2);
+    }
+    MemoryHandle handle = heap->freeHandle;
+    heap->freeHandle = heap->handles[handle].nextFree;
+    
+    CompactHeader* header = getCompactHeader(heap, heap->top);
+    header->size = blockBytes - COMPACT_HEADER_SIZE;
+    header->handle = handle;
+    header->requested = (unsigned int)size;
+    heap->handles[handle].offset = heap->top + COMPACT_HEADER_SIZE;
+    heap->handles[handle].live = 1;
+    heap->top += blockBytes;
+    
+    heap->totalBlocks++;
+    heap->totalMemoryUsed += size;
+    heap->blockBytesUsed += blockBytes;
+    if (heap->totalMemoryUsed > heap->maxMemoryUsed) {
+        heap->maxMemoryUsed = heap->totalMemoryUsed;
+    }
+    
+    profileEnd(PROFILE_COMPACT_ALLOC, begin, heap->totalMemoryUsed, heap->totalBlocks);
+    return handle;
+}
+
+// Function to get the current address of a handle's payload (NULL if the
+// handle is not live). Re-read it after every allocation or slice.
+void* compactDeref(CompactingHeap* heap, MemoryHandle handle) {
+    if (handle == 0 || handle >= heap->handleCapacity || !heap->handles[handle].live) {
+        return NULL;
+    }
+    return heap->region + heap->handles[handle].offset;
+}
+
+// Function to free a block by handle in O(1). The block stays in place as
+// dead space until the compactor passes it.
+void compactFree(CompactingHeap* heap, MemoryHandle handle) {
+    if (compactDeref(heap, handle) == NULL) {
+        return;
+    }
+    
+    double begin = profileBegin();
+    size_t offset = heap->handles[handle].offset - COMPACT_HEADER_SIZE;
+    CompactHeader* header = getCompactHeader(heap, offset);
+    size_t blockBytes = COMPACT_HEADER_SIZE + header->size;
+    
+    heap->totalBlocks--;
+    heap->totalMemoryUsed -= header->requested;
+    heap->blockBytesUsed -= blockBytes;
+    heap->deadBytes += blockBytes;
+    header->handle = 0;
+    // A running cycle reclaims blocks ahead of its write cursor itself
+    if ((!heap->compacting || offset < heap->compactWrite) && offset < heap->firstDead) {
+        heap->firstDead = offset;
+    }
+    
+    heap->handles[handle].live = 0;
+    heap->handles[handle].nextFree = heap->freeHandle;
+    heap->freeHandle = handle;
+    profileEnd(PROFILE_COMPACT_FREE, begin, heap->totalMemoryUsed, heap->totalBlocks);
+}
+
+// Function to display compacting heap statistics
+void displayCompactingStats(CompactingHeap* heap) {
+    size_t freeTail = heap->capacity - heap->top;
+    
+    printf("\n=== COMPACTING HEAP STATISTICS ===\n");
+    printCommonMemoryStats(heap->totalBlocks, heap->totalMemoryUsed, heap->maxMemoryUsed, heap->capacity);
+    printf("Block bytes in use: %zu, free tail %zu bytes\n", heap->blockBytesUsed, freeTail);
+    printf("Dead bytes awaiting compaction: %zu\n", heap->deadBytes);
+    printf("External fragmentation: %.1f%% (dead bytes outside the free tail)\n",
+           freeTail + heap->deadBytes > 0 ? (float)heap->deadBytes / (freeTail + heap->deadBytes) * 100 : 0.0f);
+    printf("Compaction: %ld cycles (%s), %ld slices, %ld full compactions\n", heap->cycles,
+           heap->compacting ? "one in progress" : "idle", heap->slices, heap->fullCompactions);
+    printf("Bytes moved: %zu, bytes reclaimed: %zu\n", heap->bytesMoved, heap->bytesReclaimed);
+    printf("Pause times: p50 %llu ns, p99 %llu ns, max %llu ns\n", getHistogramPercentile(&heap->pauses, 50),
+           getHistogramPercentile(&heap->pauses, 99), heap->pauses.maxNs);
+    printf("Failed allocations: %ld\n", heap->failedAllocations);
+    printf("==================================\n\n");
+}
+
+// Function to demonstrate handles surviving incremental compaction
+void demonstrateCompactingHeap(CompactingHeap* heap) {
+    MemoryHandle handles[8];
+    int count = 8;
+    
+    printf("\n=== COMPACTING HEAP DEMONSTRATION ===\n");
+    for (int i = 0; i < count; i++) {
+        handles[i] = compactAlloc(heap, 40 + 24 * i);
+        int* value = (int*)compactDeref(heap, handles[i]);
+        if (value != NULL) {
+            *value = 100 + i;
+            printf("Handle %u: %d bytes at offset %zu, value %d\n", handles[i], 40 + 24 * i,
+                   heap->handles[handles[i]].offset, *value);
+        } else {
+            printf("Could not allocate %d bytes\n", 40 + 24 * i);
+        }
+    }
+    
+    printf("\nFreeing every other block leaves dead holes...\n");
+    for (int i = 0; i < count; i += 2) {
+        compactFree(heap, handles[i]);
+    }
+    displayCompactingStats(heap);
+    
+    printf("Compacting in 1-microsecond slices...\n");
+    long slicesBefore = heap->slices;
+    if (heap->deadBytes > 0 || heap->compacting) {
+        while (!compactStep(heap, 1000)) {
+        }
+    }
+    printf("Cycle finished after %ld slices\n", heap->slices - slicesBefore);
+    for (int i = 1; i < count; i += 2) {
+        int* value = (int*)compactDeref(heap, handles[i]);
+        if (value != NULL) {
+            printf("Handle %u now at offset %zu, value %d\n", handles[i], heap->handles[handles[i]].offset, *value);
+        }
+    }
+    displayCompactingStats(heap);
+    
+    for (int i = 1; i < count; i += 2) {
+        compactFree(heap, handles[i]);
+    }
+    compactStep(heap, 0);
+}
+
+// Function to demonstrate aligned allocation in every allocator mode
+void demonstrateAlignedAllocation(MemoryStack* stack, SlabHeap* heap, BuddyAllocator* buddy) {
+    size_t alignments[] = {BLOCK_ALIGNMENT, 32, CACHE_LINE_SIZE};
+    size_t size = 40;
+    void* slabObjects[3];
+    void* buddyObjects[3];
+    StackMark mark = markMemoryStack(stack);
+    
+    printf("\n=== ALIGNED ALLOCATION DEMONSTRATION ===\n");
+    printf("Allocating %zu-byte arrays at 16, 32 and 64-byte alignment in each mode\n", size);
+    
+    for (int i = 0; i < 3; i++) {
+        char name[50];
+        snprintf(name, sizeof(name), "aligned%zu", alignments[i]);
+        allocateMemoryAligned(stack, BLOCK_ARRAY, name, size, alignments[i]);
+        slabObjects[i] = slabAllocAligned(heap, size, alignments[i]);
+        buddyObjects[i] = buddyAllocAligned(buddy, size, alignments[i]);
+        
+        printf("Alignment %-3zu: stack address mod 64 = %-3zu slab = %-3zu buddy = %zu\n", alignments[i],
+               (size_t)((uintptr_t)stack->top->data % CACHE_LINE_SIZE),
+               slabObjects[i] != NULL ? (size_t)((uintptr_t)slabObjects[i] % CACHE_LINE_SIZE) : 0,
+               buddyObjects[i] != NULL ? (size_t)((uintptr_t)buddyObjects[i] % CACHE_LINE_SIZE) : 0);
+    }
+    
+    printf("\nPadding overhead with all three arrays live:\n");
+    printf("Stack: ");
+    printAlignmentPadding(stack->paddingBytes, stack->totalMemoryUsed);
+    printf("Slab:  ");
+    printAlignmentPadding(heap->paddingBytes, heap->totalMemoryUsed);
+    printf("Buddy: ");
+    printAlignmentPadding(buddy->paddingBytes, buddy->totalMemoryUsed);
+    
+    for (int i = 0; i < 3; i++) {
+        slabFree(heap, slabObjects[i], size);
+        buddyFree(buddy, buddyObjects[i]);
+    }
+    releaseToMark(stack, mark);
+    printf("========================================\n");
+}
+
+// Function to get the next value from a xorshift generator (reproducible workloads)
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Function to pick a mixed object size: mostly small, sometimes up to SLAB_MAX_OBJECT
+size_t pickChurnSize(unsigned int* rngState) {
+    unsigned int r = nextRandom(rngState);
+    return (r % 100 < 80) ? 8 + (r >> 8) % 120 : 8 + (r >> 8) % (SLAB_MAX_OBJECT - 7);
+}
+
+// Function to benchmark the slab heap against malloc on mixed-size churn
+void benchmarkSlabHeap(int liveSlots, long operations, unsigned int seed) {
+    void** objects = (void**)calloc(liveSlots, sizeof(void*));
+    size_t* sizes = (size_t*)calloc(liveSlots, sizeof(size_t));
+    SlabHeap* heap = createSlabHeap((size_t)liveSlots * SLAB_MAX_OBJECT + 64 * SLAB_SIZE);
+    double elapsed[2];
+    
+    // Run the identical operation sequence against both allocators
+    for (int mode = 0; mode < 2; mode++) {
+        unsigned int rngState = seed != 0 ? seed : 1;
+        double begin = currentTimeNs();
+        
+        for (long op = 0; op < operations; op++) {
+            int slot = (int)(nextRandom(&rngState) % liveSlots);
+            
+            if (objects[slot] != NULL) {
+                if (mode == 0) {
+                    slabFree(heap, objects[slot], sizes[slot]);
+                } else {
+                    free(objects[slot]);
+                }
+                objects[slot] = NULL;
+            } else {
+                sizes[slot] = pickChurnSize(&rngState);
+                objects[slot] = mode == 0 ? slabAlloc(heap, sizes[slot]) : malloc(sizes[slot]);
+                if (objects[slot] != NULL) {
+                    *(char*)objects[slot] = (char)op; // Touch the object
+                }
+            }
+        }
+        elapsed[mode] = currentTimeNs() - begin;
+        
+        if (mode == 0) {
+            printf("\n=== SLAB HEAP vs MALLOC BENCHMARK ===\n");
+            printf("%d live slots, %ld operations, seed %u\n", liveSlots, operations, seed);
+            printf("Slab heap state after churn:\n");
+            displaySlabHeapStats(heap);
+        }
+        
+        for (int i = 0; i < liveSlots; i++) {
+            if (objects[i] != NULL) {
+                if (mode == 0) {
+                    slabFree(heap, objects[i], sizes[i]);
+                } else {
+                    free(objects[i]);
+                }
+                objects[i] = NULL;
+            }
+        }
+    }
+    
+    printf("%-10s %14s %16s\n", "Allocator", "Time (ms)", "Ops/sec");
+    printf("%-10s %14.2f %16.0f\n", "slab", elapsed[0] / 1e6, operations / (elapsed[0] / 1e9));
+    printf("%-10s %14.2f %16.0f\n", "malloc", elapsed[1] / 1e6, operations / (elapsed[1] / 1e9));
+    printf("=====================================\n");
+    
+    freeSlabHeap(heap);
+    free(objects);
+    free(sizes);
+}
+
+// Arena bound to the calling thread (NULL for threads without one)
+static _Thread_local ThreadArena* currentArena = NULL;
+
+// Function to detect the number of online CPUs (at least 1)
+int detectCpuCount() {
+#ifdef _WIN32
+    SYSTEM_INFO info;
+    GetSystemInfo(&info);
+    return (int)info.dwNumberOfProcessors;
+#else
+    long count = sysconf(_SC_NPROCESSORS_ONLN);
+    return count > 0 ? (int)count : 1;
+#endif
+}
+
+// Function to create a pool of thread arenas, each with its own slab heap
+ThreadArenaPool* createThreadArenaPool(int count, size_t bytesPerArena) {
+    ThreadArenaPool* pool = (ThreadArenaPool*)malloc(sizeof(ThreadArenaPool));
+    pool->count = count;
+    pool->arenas = (ThreadArena**)malloc(count * sizeof(ThreadArena*));
+    
+    for (int i = 0; i < count; i++) {
+        ThreadArena* arena = (ThreadArena*)calloc(1, sizeof(ThreadArena));
+        atomic_init(&arena->remoteFrees, NULL);
+        arena->heap = createSlabHeap(bytesPerArena);
+        arena->heap->owner = arena;
+        pool->arenas[i] = arena;
+    }
+    
+    return pool;
+}
+
+// Function to bind the calling thread to one arena of the pool
+void bindThreadArena(ThreadArenaPool* pool, int index) {
+    currentArena = index >= 0 && index < pool->count ? pool->arenas[index] : NULL;
+}
+
+// Function to publish the owner's private heap counters for on-demand merging.
+// Only the owner writes these, so relaxed stores are enough (no locked RMW).
+void publishArenaStats(ThreadArena* arena) {
+    atomic_store_explicit(&arena->liveBlocks, arena->heap->totalBlocks, memory_order_relaxed);
+    atomic_store_explicit(&arena->liveBytes, arena->heap->totalMemoryUsed, memory_order_relaxed);
+    atomic_store_explicit(&arena->maxBytes, arena->heap->maxMemoryUsed, memory_order_relaxed);
+    atomic_store_explicit(&arena->paddingBytes, arena->heap->paddingBytes, memory_order_relaxed);
+}
+
+// Function to add to a counter that only the owning thread writes
+void bumpArenaCounter(atomic_long* counter, long amount) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + amount,
+                          memory_order_relaxed);
+}
+
+// Function to take every pending remote free at once and return it to the
+// owner's heap. Only the owner calls this (or anyone once the owner has exited).
+void drainRemoteFrees(ThreadArena* arena) {
+    RemoteFree* node = atomic_exchange_explicit(&arena->remoteFrees, NULL, memory_order_acquire);
+    long received = 0;
+    
+    while (node != NULL) {
+        RemoteFree* next = node->next;
+        slabFree(arena->heap, node, node->size);
+        node = next;
+        received++;
+    }
+    
+    if (received > 0) {
+        bumpArenaCounter(&arena->remoteFreesReceived, received);
+        publishArenaStats(arena);
+    }
+}
+
+// Function to allocate an aligned object from the calling thread's arena
+// (NULL if none is bound or it is full)
+void* threadArenaAllocAligned(size_t size, size_t alignment) {
+    ThreadArena* arena = currentArena;
+    if (arena == NULL) {
+        return NULL;
+    }
+    
+    // Reclaim objects other threads freed before taking new slots
+    if (atomic_load_explicit(&arena->remoteFrees, memory_order_relaxed) != NULL) {
+        drainRemoteFrees(arena);
+    }
+    
+    void* ptr = slabAllocAligned(arena->heap, size, alignment);
+    if (ptr != NULL) {
+        bumpArenaCounter(&arena->allocations, 1);
+    } else {
+        bumpArenaCounter(&arena->failedAllocations, 1);
+    }
+    publishArenaStats(arena);
+    return ptr;
+}
+
+// Function to allocate from the calling thread's arena (NULL if none is bound or it is full)
+void* threadArenaAlloc(size_t size) {
+    return threadArenaAllocAligned(size, BLOCK_ALIGNMENT);
+}
+
+// Function to free an object from any thread. Objects owned by the calling
+// thread go straight back to its heap; others are pushed onto the owner's
+// remote-free queue with a CAS, reusing the object's own bytes as the node.
+void threadArenaFree(void* ptr, size_t size) {
+    if (ptr == NULL) {
+        return;
+    }
+    
+    Slab* slab = (Slab*)((uintptr_t)ptr & ~(uintptr_t)(SLAB_SIZE - 1));
+    ThreadArena* owner = slab->heap->owner;
+    
+    if (owner == currentArena) {
+        slabFree(owner->heap, ptr, size);
+        bumpArenaCounter(&owner->localFrees, 1);
+        publishArenaStats(owner);
+        return;
+    }
+    
+    RemoteFree* node = (RemoteFree*)ptr;
+    node->size = size;
+    node->next = atomic_load_explicit(&owner->remoteFrees, memory_order_relaxed);
+    while (!atomic_compare_exchange_weak_explicit(&owner->remoteFrees, &node->next, node,
+                                                  memory_order_release, memory_order_relaxed)) {
+        // node->next now holds the current head; retry
+    }
+    
+    if (currentArena != NULL) {
+        bumpArenaCounter(&currentArena->remoteFreesSent, 1);
+    }
+}
+
+// Function to merge the published counters of every arena (safe while threads run)
+ThreadArenaStats mergeThreadArenaStats(ThreadArenaPool* pool) {
+    ThreadArenaStats stats;
+    memset(&stats, 0, sizeof(stats));
+    
+    for (int i = 0; i < pool->count; i++) {
+        ThreadArena* arena = pool->arenas[i];
+        stats.totalBlocks += atomic_load_explicit(&arena->liveBlocks, memory_order_relaxed);
+        stats.totalMemoryUsed += atomic_load_explicit(&arena->liveBytes, memory_order_relaxed);
+        stats.maxMemoryUsed += atomic_load_explicit(&arena->maxBytes, memory_order_relaxed);
+        stats.paddingBytes += atomic_load_explicit(&arena->paddingBytes, memory_order_relaxed);
+        stats.capacity += arena->heap->capacity;
+        stats.allocations += atomic_load_explicit(&arena->allocations, memory_order_relaxed);
+        stats.localFrees += atomic_load_explicit(&arena->localFrees, memory_order_relaxed);
+        stats.remoteFreesSent += atomic_load_explicit(&arena->remoteFreesSent, memory_order_relaxed);
+        stats.remoteFreesReceived += atomic_load_explicit(&arena->remoteFreesReceived, memory_order_relaxed);
+        stats.failedAllocations += atomic_load_explicit(&arena->failedAllocations, memory_order_relaxed);
+    }
+    stats.remoteFreesPending = stats.allocations - stats.localFrees - stats.remoteFreesReceived -
+                               stats.totalBlocks;
+    
+    return stats;
+}
+
+// Function to display merged thread arena statistics
+void displayThreadArenaStats(ThreadArenaPool* pool) {
+    ThreadArenaStats stats = mergeThreadArenaStats(pool);
+    
+    printf("\n=== THREAD ARENA STATISTICS (%d arenas) ===\n", pool->count);
+    printCommonMemoryStats(stats.totalBlocks, stats.totalMemoryUsed, stats.maxMemoryUsed, stats.capacity);
+    printAlignmentPadding(stats.paddingBytes, stats.totalMemoryUsed);
+    printf("Allocations: %ld\n", stats.allocations);
+    printf("Local frees: %ld\n", stats.localFrees);
+    printf("Remote frees: %ld sent, %ld received, %ld waiting in queues\n",
+           stats.remoteFreesSent, stats.remoteFreesReceived, stats.remoteFreesPending);
+    printf("Failed allocations: %ld\n", stats.failedAllocations);
+    printf("============================================\n\n");
+}
+
+// Function to free a pool and the heap of every arena
+void freeThreadArenaPool(ThreadArenaPool* pool) {
+    for (int i = 0; i < pool->count; i++) {
+        freeSlabHeap(pool->arenas[i]->heap);
+        free(pool->arenas[i]);
+    }
+    free(pool->arenas);
+    free(pool);
+}
+
+// Single-producer single-consumer ring that hands live objects to another thread
+typedef struct HandoffRing {
+    atomic_size_t head;               // Next slot the consumer reads
+    char padding[CACHE_LINE_SIZE];
+    atomic_size_t tail;               // Next slot the producer writes
+    void* objects[HANDOFF_RING_SIZE];
+    size_t sizes[HANDOFF_RING_SIZE];
+} HandoffRing;
+
+// Per-thread context for the allocation storm benchmark
+typedef struct StormWorker {
+    pthread_t thread;
+    ThreadArenaPool* pool;           // NULL when benchmarking malloc
+    int index;
+    int liveSlots;
+    long operations;
+    int remotePercent;
+    unsigned int seed;
+    HandoffRing* outgoing;           // Objects this thread gives away
+    HandoffRing* incoming;           // Objects this thread frees for another thread
+} StormWorker;
+
+// Function to free an object in the benchmark's current mode
+void stormFree(StormWorker* worker, void* ptr, size_t size) {
+    if (worker->pool != NULL) {
+        threadArenaFree(ptr, size);
+    } else {
+        free(ptr);
+    }
+}
+
+// Function run by each storm thread: random allocate/free on private slots,
+// passing some objects to the next thread, which frees them (cross-thread frees)
+void* stormWorker(void* arg) {
+    StormWorker* worker = (StormWorker*)arg;
+    void** objects = (void**)calloc(worker->liveSlots, sizeof(void*));
+    size_t* sizes = (size_t*)calloc(worker->liveSlots, sizeof(size_t));
+    unsigned int rngState = worker->seed != 0 ? worker->seed : 1;
+    
+    if (worker->pool != NULL) {
+        bindThreadArena(worker->pool, worker->index);
+    }
+    
+    for (long op = 0; op < worker->operations; op++) {
+        unsigned int r = nextRandom(&rngState);
+        int slot = (int)(r % worker->liveSlots);
+        
+        if (objects[slot] != NULL) {
+            HandoffRing* ring = worker->outgoing;
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_relaxed);
+            
+            if ((int)((r >> 16) % 100) < worker->remotePercent &&
+                tail - atomic_load_explicit(&ring->head, memory_order_acquire) < HANDOFF_RING_SIZE) {
+                ring->objects[tail & (HANDOFF_RING_SIZE - 1)] = objects[slot];
+                ring->sizes[tail & (HANDOFF_RING_SIZE - 1)] = sizes[slot];
+                atomic_store_explicit(&ring->tail, tail + 1, memory_order_release);
+            } else {
+                stormFree(worker, objects[slot], sizes[slot]);
+            }
+            objects[slot] = NULL;
+        } else {
+            sizes[slot] = pickChurnSize(&rngState);
+            objects[slot] = worker->pool != NULL ? threadArenaAlloc(sizes[slot]) : malloc(sizes[slot]);
+            if (objects[slot] != NULL) {
+                *(char*)objects[slot] = (char)op; // Touch the object
+            }
+        }
+        
+        // Free whatever the previous thread handed over
+        if ((op & 15) == 0) {
+            HandoffRing* ring = worker->incoming;
+            size_t head = atomic_load_explicit(&ring->head, memory_order_relaxed);
+            size_t tail = atomic_load_explicit(&ring->tail, memory_order_acquire);
+            
+            while (head != tail) {
+                stormFree(worker, ring->objects[head & (HANDOFF_RING_SIZE - 1)],
+                          ring->sizes[head & (HANDOFF_RING_SIZE - 1)]);
+                head++;
+            }
+            atomic_store_explicit(&ring->head, head, memory_order_release);
+        }
+    }
+    
+    for (int i = 0; i < worker->liveSlots; i++) {
+        stormFree(worker, objects[i], sizes[i]);
+    }
+    
+    free(objects);
+    free(sizes);
+    return NULL;
+}
+
+// Function to run one storm with the given thread count; returns elapsed ns.
+// When pool is NULL the storm uses malloc/free.
+double runAllocationStorm(ThreadArenaPool* pool, int threads, int liveSlots, long operations,
+                          int remotePercent, unsigned int seed) {
+    StormWorker* workers = (StormWorker*)calloc(threads, sizeof(StormWorker));
+    HandoffRing* rings = (HandoffRing*)calloc(threads, sizeof(HandoffRing));
+    
+    for (int i = 0; i < threads; i++) {
+        workers[i].pool = pool;
+        workers[i].index = i;
+        workers[i].liveSlots = liveSlots;
+        workers[i].operations = operations;
+        workers[i].remotePercent = remotePercent;
+        workers[i].seed = seed + (unsigned int)i * 7919;
+        workers[i].outgoing = &rings[i];
+        workers[i].incoming = &rings[(i + threads - 1) % threads];
+    }
+    
+    double begin = currentTimeNs();
+    for (int i = 0; i < threads; i++) {
+        pthread_create(&workers[i].thread, NULL, stormWorker, &workers[i]);
+    }
+    for (int i = 0; i < threads; i++) {
+        pthread_join(workers[i].thread, NULL);
+    }
+    double elapsed = currentTimeNs() - begin;
+    
+    // Objects still in flight when the consumers stopped
+    for (int i = 0; i < threads; i++) {
+        size_t head = atomic_load(&rings[i].head);
+        size_t tail = atomic_load(&rings[i].tail);
+        for (; head != tail; head++) {
+            void* ptr = rings[i].objects[head & (HANDOFF_RING_SIZE - 1)];
+            size_t size = rings[i].sizes[head & (HANDOFF_RING_SIZE - 1)];
+            if (pool != NULL) {
+                threadArenaFree(ptr, size);
+            } else {
+                free(ptr);
+            }
+        }
+    }
+    
+    free(workers);
+    free(rings);
+    return elapsed;
+}
+
+// Function to benchmark thread arenas against malloc with 1, 2, 4, ... threads
+void benchmarkThreadArenas(int maxThreads, long operations, int liveSlots, int remotePercent, unsigned int seed) {
+    size_t bytesPerArena = (size_t)(liveSlots + HANDOFF_RING_SIZE) * SLAB_MAX_OBJECT + 64 * SLAB_SIZE;
+    double baseline[2] = {0.0, 0.0};
+    
+    printf("\n=== THREAD ARENA vs MALLOC STORM ===\n");
+    printf("%ld operations per thread, %d live slots per thread, %d%% freed by another thread, %d CPUs\n",
+           operations, liveSlots, remotePercent, detectCpuCount());
+    printf("%-8s %-10s %12s %16s %10s\n", "Threads", "Allocator", "Time (ms)", "Ops/sec", "Scaling");
+    
+    for (int threads = 1; threads <= maxThreads; threads = threads < maxThreads && threads * 2 > maxThreads ?
+                                                            maxThreads : threads * 2) {
+        ThreadArenaPool* pool = createThreadArenaPool(threads, bytesPerArena);
+        double elapsed[2];
+        
+        elapsed[0] = runAllocationStorm(pool, threads, liveSlots, operations, remotePercent, seed);
+        elapsed[1] = runAllocationStorm(NULL, threads, liveSlots, operations, remotePercent, seed);
+        
+        for (int mode = 0; mode < 2; mode++) {
+            double opsPerSec = threads * operations / (elapsed[mode] / 1e9);
+            if (threads == 1) {
+                baseline[mode] = opsPerSec;
+            }
+            printf("%-8d %-10s %12.2f %16.0f %9.2fx\n", threads, mode == 0 ? "arenas" : "malloc",
+                   elapsed[mode] / 1e6, opsPerSec, opsPerSec / baseline[mode]);
+        }
+        
+        // Owners have exited, so the main thread returns their pending remote frees
+        for (int i = 0; i < threads; i++) {
+            drainRemoteFrees(pool->arenas[i]);
+        }
+        if (threads == maxThreads) {
+            displayThreadArenaStats(pool);
+        }
+        freeThreadArenaPool(pool);
+        
+        if (threads == maxThreads) {
+            break;
+        }
+    }
+    printf("====================================\n");
+}
+
+// Function to write a 32-bit value little-endian (trace files are portable)
+void writeLe32(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+// Function to read a 32-bit little-endian value
+unsigned int readLe32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8) |
+           ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+// Function to save a trace: a 16-byte header (magic, version, record count)
+// followed by TRACE_RECORD_BYTES per record
+int saveAllocationTrace(AllocationTrace* trace, const char* path) {
+    FILE* file = fopen(path, "wb");
+    if (file == NULL) {
+        printf("Error: Cannot open '%s' for writing\n", path);
+        return 0;
+    }
+    
+    unsigned char header[16];
+    writeLe32(header, TRACE_MAGIC);
+    writeLe32(header + 4, TRACE_VERSION);
+    writeLe32(header + 8, (unsigned int)trace->count);
+    writeLe32(header + 12, (unsigned int)((unsigned long long)trace->count >> 32));
+    fwrite(header, 1, sizeof(header), file);
+    
+    unsigned char buffer[TRACE_RECORD_BYTES * 256];
+    size_t used = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        writeLe32(buffer + used, record->lifetimeId);
+        writeLe32(buffer + used + 4, record->size);
+        buffer[used + 8] = record->op;
+        buffer[used + 9] = record->alignmentLog2;
+        used += TRACE_RECORD_BYTES;
+        if (used == sizeof(buffer) || i + 1 == trace->count) {
+            fwrite(buffer, 1, used, file);
+            used = 0;
+        }
+    }
+    
+    int ok = !ferror(file);
+    fclose(file);
+    return ok;
+}
+
+// Function to find where a file lifetime id sits in the load-time id map:
+// its own slot, or the empty slot it would take
+size_t findTraceIdSlot(const unsigned int* fileIds, size_t capacity, unsigned int fileId) {
+    size_t slot = hashBlockId((int)fileId, capacity);
+    while (fileIds[slot] != 0 && fileIds[slot] != fileId) {
+        slot = (slot + 1) & (capacity - 1);
+    }
+    return slot;
+}
+
+// Function to load a trace saved by saveAllocationTrace (NULL on error).
+// Lifetime ids are remapped to dense ids in allocation order, so replay
+// arrays are sized by the record count, never by ids read from the file.
+AllocationTrace* loadAllocationTrace(const char* path) {
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        printf("Error: Cannot open '%s'\n", path);
+        return NULL;
+    }
+    
+    unsigned char header[16];
+    if (fread(header, 1, sizeof(header), file) != sizeof(header) ||
+        readLe32(header) != TRACE_MAGIC || readLe32(header + 4) != TRACE_VERSION) {
+        printf("Error: '%s' is not an allocation trace\n", path);
+        fclose(file);
+        return NULL;
+    }
+    
+    size_t count = (size_t)(readLe32(header + 8) | ((unsigned long long)readLe32(header + 12) << 32));
+    AllocationTrace* trace = createAllocationTrace();
+    unsigned char record[TRACE_RECORD_BYTES];
+    // Map from file id to dense id (0 once freed), doubled at half load
+    size_t mapCapacity = 1024, mapUsed = 0;
+    unsigned int* fileIds = (unsigned int*)calloc(mapCapacity, sizeof(unsigned int));
+    unsigned int* denseIds = (unsigned int*)calloc(mapCapacity, sizeof(unsigned int));
+    int ok = fileIds != NULL && denseIds != NULL;
+    if (!ok) {
+        printf("Error: Not enough memory to load '%s'\n", path);
+    }
+    
+    for (size_t i = 0; ok && i < count; i++) {
+        if (fread(record, 1, sizeof(record), file) != sizeof(record)) {
+            printf("Error: '%s' is truncated after %zu records\n", path, i);
+            ok = 0;
+            break;
+        }
+        
+        // Reject unknown ops, alignments that cannot be shifted into a size_t
+        // and the ids no recorder hands out
+        unsigned int fileId = readLe32(record);
+        if (record[8] > TRACE_FREE || record[9] >= sizeof(size_t) * 8 || fileId == 0 || fileId == UINT_MAX) {
+            printf("Error: '%s' has a corrupt record at %zu (op %d, alignment log2 %d, id %u)\n",
+                   path, i, record[8], record[9], fileId);
+            ok = 0;
+            break;
+        }
+        
+        if ((mapUsed + 1) * 2 > mapCapacity) {
+            unsigned int* oldFileIds = fileIds;
+            unsigned int* oldDenseIds = denseIds;
+            size_t oldCapacity = mapCapacity;
+            mapCapacity *= 2;
+            fileIds = (unsigned int*)calloc(mapCapacity, sizeof(unsigned int));
+            denseIds = (unsigned int*)calloc(mapCapacity, sizeof(unsigned int));
+            if (fileIds == NULL || denseIds == NULL) {
+                printf("Error: Not enough memory to load '%s'\n", path);
+                free(oldFileIds);
+                free(oldDenseIds);
+                ok = 0;
+                break;
+            }
+            for (size_t j = 0; j < oldCapacity; j++) {
+                if (oldFileIds[j] != 0) {
+                    size_t slot = findTraceIdSlot(fileIds, mapCapacity, oldFileIds[j]);
+                    fileIds[slot] = oldFileIds[j];
+                    denseIds[slot] = oldDenseIds[j];
+                }
+            }
+            free(oldFileIds);
+            free(oldDenseIds);
+        }
+        
+        size_t slot = findTraceIdSlot(fileIds, mapCapacity, fileId);
+        unsigned int lifetimeId;
+        if (record[8] == TRACE_ALLOC) {
+            if (fileIds[slot] == 0) {
+                fileIds[slot] = fileId;
+                mapUsed++;
+            }
+            lifetimeId = trace->nextLifetimeId++;
+            denseIds[slot] = lifetimeId;
+        } else {
+            // A free of an id that is not live replays as a no-op on id 0
+            lifetimeId = fileIds[slot] == fileId ? denseIds[slot] : 0;
+            denseIds[slot] = 0;
+        }
+        appendTraceRecord(trace, (TraceOp)record[8], lifetimeId, readLe32(record + 4), (size_t)1 << record[9]);
+    }
+    
+    free(fileIds);
+    free(denseIds);
+    fclose(file);
+    if (!ok) {
+        freeAllocationTrace(trace);
+        return NULL;
+    }
+    return trace;
+}
+
+// Function to generate a reproducible churn trace: random allocate/free on
+// liveSlots slots with mixed sizes and mostly default alignment
+AllocationTrace* generateChurnTrace(long operations, int liveSlots, unsigned int seed) {
+    AllocationTrace* trace = createAllocationTrace();
+    unsigned int* slots = (unsigned int*)calloc(liveSlots, sizeof(unsigned int));
+    unsigned int rngState = seed != 0 ? seed : 1;
+    
+    for (long op = 0; op < operations; op++) {
+        int slot = (int)(nextRandom(&rngState) % liveSlots);
+        
+        if (slots[slot] != 0) {
+            appendTraceRecord(trace, TRACE_FREE, slots[slot], 0, 1);
+            slots[slot] = 0;
+        } else {
+            size_t size = pickChurnSize(&rngState);
+            size_t alignment = nextRandom(&rngState) % 8 == 0 ? CACHE_LINE_SIZE : BLOCK_ALIGNMENT;
+            slots[slot] = trace->nextLifetimeId++;
+            appendTraceRecord(trace, TRACE_ALLOC, slots[slot], size, alignment);
+        }
+    }
+    
+    // Free whatever is still live so the trace ends empty
+    for (int i = 0; i < liveSlots; i++) {
+        if (slots[i] != 0) {
+            appendTraceRecord(trace, TRACE_FREE, slots[i], 0, 1);
+        }
+    }
+    
+    free(slots);
+    return trace;
+}
+
+// Function to get the resident set size of the process in bytes (0 if unknown)
+size_t currentRssBytes() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return counters.WorkingSetSize;
+    }
+    return 0;
+#else
+    FILE* file = fopen("/proc/self/statm", "r");
+    unsigned long totalPages = 0, residentPages = 0;
+    if (file == NULL) {
+        return 0;
+    }
+    if (fscanf(file, "%lu %lu", &totalPages, &residentPages) != 2) {
+        residentPages = 0;
+    }
+    fclose(file);
+    return (size_t)residentPages * (size_t)sysconf(_SC_PAGESIZE);
+#endif
+}
+
+// Function to allocate from the system allocator with the given alignment
+void* alignedMalloc(size_t size, size_t alignment) {
+#ifdef _WIN32
+    return _aligned_malloc(size, alignment);
+#else
+    return alignment <= BLOCK_ALIGNMENT ? malloc(size) : aligned_alloc(alignment, alignUp(size, alignment));
+#endif
+}
+
+// Function to free memory from alignedMalloc
+void alignedFree(void* ptr) {
+#ifdef _WIN32
+    _aligned_free(ptr);
+#else
+    free(ptr);
+#endif
+}
+
+// Function to get the display name of a replay engine
+const char* getReplayEngineName(ReplayEngine engine) {
+    switch (engine) {
+        case REPLAY_MALLOC: return "malloc";
+        case REPLAY_SLAB: return "slab";
+        case REPLAY_BUDDY: return "buddy";
+        case REPLAY_TLSF: return "tlsf";
+        default: return "unknown";
+    }
+}
+
+// Function to compare latencies for qsort
+int compareLatency(const void* a, const void* b) {
+    unsigned int left = *(const unsigned int*)a;
+    unsigned int right = *(const unsigned int*)b;
+    return (left > right) - (left < right);
+}
+
+// Function to replay a trace against one allocator engine. Every operation is
+// timed on its own; objects are filled outside the timed region so RSS reflects use.
+ReplayResult replayAllocationTrace(AllocationTrace* trace, ReplayEngine engine) {
+    ReplayResult result;
+    memset(&result, 0, sizeof(result));
+    
+    void** objects = (void**)calloc(trace->nextLifetimeId, sizeof(void*));
+    size_t* sizes = (size_t*)calloc(trace->nextLifetimeId, sizeof(size_t));
+    unsigned int* latencies = (unsigned int*)malloc((trace->count + 1) * sizeof(unsigned int));
+    if (objects == NULL || sizes == NULL || latencies == NULL) {
+        // operations stays 0, so callers skip this engine
+        printf("Error: Not enough memory to replay %zu records\n", trace->count);
+        free(objects);
+        free(sizes);
+        free(latencies);
+        return result;
+    }
+    
+    // Size the fixed-region engines from the trace's peak live bytes
+    size_t liveBytes = 0, peakLive = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        if (record->op == TRACE_ALLOC) {
+            sizes[record->lifetimeId] = record->size;
+            liveBytes += record->size;
+            if (liveBytes > peakLive) {
+                peakLive = liveBytes;
+            }
+        } else {
+            liveBytes -= sizes[record->lifetimeId];
+        }
+    }
+    
+    size_t rssBefore = currentRssBytes(), peakRss = rssBefore;
+    SlabHeap* heap = NULL;
+    BuddyAllocator* buddy = NULL;
+    TlsfAllocator* tlsf = NULL;
+    if (engine == REPLAY_SLAB) {
+        heap = createSlabHeap(alignUp(peakLive * 4, SLAB_SIZE) + SLAB_CLASS_COUNT * 16 * SLAB_SIZE);
+    } else if (engine == REPLAY_BUDDY) {
+        buddy = createBuddyAllocator(peakLive * 4 + SLAB_SIZE);
+    } else if (engine == REPLAY_TLSF) {
+        tlsf = createTlsfAllocator(peakLive * 2 + 16 * SLAB_SIZE);
+    }
+    
+    // Fault the fixed regions in up front so first-touch page faults do not
+    // land in the timed operations (malloc still takes them as it grows)
+    if (heap != NULL) {
+        for (int i = 0; i < heap->slabCount; i++) {
+            ((volatile unsigned char*)heap->base)[(size_t)i * SLAB_SIZE + SLAB_SIZE - 1] = 0;
+        }
+    } else if (buddy != NULL) {
+        memset(buddy->region + BUDDY_HEADER_SIZE + 2 * sizeof(void*), 0,
+               buddy->capacity - BUDDY_HEADER_SIZE - 2 * sizeof(void*));
+    } else if (tlsf != NULL) {
+        memset(tlsf->region + sizeof(TlsfBlock), 0, tlsf->capacity - sizeof(TlsfBlock) - TLSF_HEADER_SIZE);
+    }
+    
+    liveBytes = 0;
+    double replayBegin = currentTimeNs();
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        unsigned int id = record->lifetimeId;
+        size_t alignment = (size_t)1 << record->alignmentLog2;
+        double begin = currentTimeNs();
+        
+        if (record->op == TRACE_ALLOC) {
+            switch (engine) {
+                case REPLAY_MALLOC: objects[id] = alignedMalloc(record->size, alignment); break;
+                case REPLAY_SLAB: objects[id] = slabAllocAligned(heap, record->size, alignment); break;
+                case REPLAY_BUDDY: objects[id] = buddyAllocAligned(buddy, record->size, alignment); break;
+                case REPLAY_TLSF: objects[id] = tlsfAllocAligned(tlsf, record->size, alignment); break;
+                default: objects[id] = NULL;
+            }
+        } else if (objects[id] != NULL) {
+            switch (engine) {
+                case REPLAY_MALLOC: alignedFree(objects[id]); break;
+                case REPLAY_SLAB: slabFree(heap, objects[id], sizes[id]); break;
+                case REPLAY_BUDDY: buddyFree(buddy, objects[id]); break;
+                case REPLAY_TLSF: tlsfFree(tlsf, objects[id], sizes[id]); break;
+                default: break;
+            }
+        }
+        
+        latencies[i] = (unsigned int)(currentTimeNs() - begin);
+        
+        if (record->op == TRACE_ALLOC) {
+            if (objects[id] == NULL) {
+                result.failedAllocations++;
+            } else {
+                memset(objects[id], 0xA5, record->size);
+                liveBytes += record->size;
+                if (liveBytes > result.peakLiveBytes) {
+                    result.peakLiveBytes = liveBytes;
+                    if (engine == REPLAY_SLAB) {
+                        result.peakFootprint = heap->slotBytesUsed;
+                    } else if (engine == REPLAY_BUDDY) {
+                        result.peakFootprint = buddy->blockBytesUsed;
+                    } else if (engine == REPLAY_TLSF) {
+                        result.peakFootprint = tlsf->blockBytesUsed;
+                    }
+                }
+            }
+        } else if (objects[id] != NULL) {
+            liveBytes -= sizes[id];
+            objects[id] = NULL;
+        }
+        
+        if (i % RSS_SAMPLE_INTERVAL == 0) {
+            size_t rss = currentRssBytes();
+            if (rss > peakRss) {
+                peakRss = rss;
+            }
+        }
+    }
+    result.elapsedNs = currentTimeNs() - replayBegin;
+    result.operations = (long)trace->count;
+    result.peakRssDelta = peakRss - rssBefore;
+    
+    // Free anything a truncated trace left live
+    for (unsigned int id = 1; id < trace->nextLifetimeId; id++) {
+        if (objects[id] != NULL && engine == REPLAY_MALLOC) {
+            alignedFree(objects[id]);
+        }
     }
-    printf("========================================\n\n");
+    
+    if (trace->count > 0) {
+        qsort(latencies, trace->count, sizeof(unsigned int), compareLatency);
+        result.p50Ns = latencies[(size_t)(trace->count * 0.50)];
+        result.p90Ns = latencies[(size_t)(trace->count * 0.90)];
+        result.p99Ns = latencies[(size_t)(trace->count * 0.99)];
+        result.p999Ns = latencies[(size_t)(trace->count * 0.999)];
+        result.maxNs = latencies[trace->count - 1];
+    }
+    
+    if (heap != NULL) {
+        freeSlabHeap(heap);
+    }
+    if (buddy != NULL) {
+        freeBuddyAllocator(buddy);
+    }
+    if (tlsf != NULL) {
+        freeTlsfAllocator(tlsf);
+    }
+    free(objects);
+    free(sizes);
+    free(latencies);
+    return result;
 }
 
-// Function to display memory statistics
-void displayMemoryStats(MemoryStack* stack) {
-    printf("\n=== MEMORY STATISTICS ===\n");
-    printf("Total blocks: %d\n", stack->totalBlocks);
-    printf("Memory used: %zu bytes\n", stack->totalMemoryUsed);
-    printf("Max memory used: %zu bytes\n", stack->maxMemoryUsed);
-    printf("Available memory: %d bytes\n", MAX_STACK_SIZE - (int)stack->totalMemoryUsed);
-    printf("Memory utilization: %.1f%%\n", 
-           (float)stack->totalMemoryUsed / MAX_STACK_SIZE * 100);
-    printf("Next block ID: %d\n", stack->nextBlockId);
-    printf("=========================\n\n");
+// Function to generate the split/coalesce pattern: fill and empty the
+// allocator with 256-byte objects once, then alternate allocating and
+// freeing one tiny object, so a buddy allocator splits from the top order
+// and coalesces back on every pair
+AllocationTrace* generateSplitCoalesceTrace(long operations) {
+    AllocationTrace* trace = createAllocationTrace();
+    int fill = 4096;
+    
+    for (int i = 0; i < fill; i++) {
+        appendTraceRecord(trace, TRACE_ALLOC, trace->nextLifetimeId++, 256, BLOCK_ALIGNMENT);
+    }
+    for (int i = 1; i <= fill; i++) {
+        appendTraceRecord(trace, TRACE_FREE, (unsigned int)i, 0, 1);
+    }
+    for (long op = 0; op + 1 < operations; op += 2) {
+        unsigned int id = trace->nextLifetimeId++;
+        appendTraceRecord(trace, TRACE_ALLOC, id, 16, BLOCK_ALIGNMENT);
+        appendTraceRecord(trace, TRACE_FREE, id, 0, 1);
+    }
+    return trace;
 }
 
-// Function to simulate function call with local variables
-void simulateFunctionCall(MemoryStack* stack, char* functionName) {
-    printf("\n=== SIMULATING FUNCTION CALL: %s ===\n", functionName);
+// Function to generate the sawtooth pattern: allocate a run of mixed sizes,
+// free every other object to leave small holes, then allocate objects too
+// large for any hole before freeing everything; repeated for each round
+AllocationTrace* generateSawtoothTrace(long operations, unsigned int seed) {
+    AllocationTrace* trace = createAllocationTrace();
+    int run = 2048;
+    unsigned int* ids = (unsigned int*)malloc((run + run / 2) * sizeof(unsigned int));
+    unsigned int rngState = seed != 0 ? seed : 1;
     
-    // Create stack frame marker
-    printf("Creating stack frame for function %s...\n", functionName);
-    
-    // Allocate local variables
-    allocateMemory(stack, BLOCK_INT, "localVar1", sizeof(int));
-    int val1 = 42;
-    setTopBlockValue(stack, &val1);
+    while ((long)trace->count < operations) {
+        for (int i = 0; i < run; i++) {
+            ids[i] = trace->nextLifetimeId++;
+            appendTraceRecord(trace, TRACE_ALLOC, ids[i], 16 + nextRandom(&rngState) % 240, BLOCK_ALIGNMENT);
+        }
+        for (int i = 0; i < run; i += 2) {
+            appendTraceRecord(trace, TRACE_FREE, ids[i], 0, 1);
+        }
+        for (int i = 0; i < run / 2; i++) {
+            ids[run + i] = trace->nextLifetimeId++;
+            appendTraceRecord(trace, TRACE_ALLOC, ids[run + i], 512 + nextRandom(&rngState) % 512,
+                              nextRandom(&rngState) % 4 == 0 ? CACHE_LINE_SIZE : BLOCK_ALIGNMENT);
+        }
+        for (int i = 1; i < run; i += 2) {
+            appendTraceRecord(trace, TRACE_FREE, ids[i], 0, 1);
+        }
+        for (int i = 0; i < run / 2; i++) {
+            appendTraceRecord(trace, TRACE_FREE, ids[run + i], 0, 1);
+        }
+    }
     
-    allocateMemory(stack, BLOCK_FLOAT, "localVar2", sizeof(float));
-    float val2 = 3.14f;
-    setTopBlockValue(stack, &val2);
+    free(ids);
+    return trace;
+}
+
+// Function to benchmark tail latency (p99, p99.9 and worst case) of every
+// allocator engine on adversarial allocation patterns
+void benchmarkWorstCaseLatency(long operations, unsigned int seed) {
+    const char* patternNames[] = {"churn", "split-coalesce", "sawtooth"};
     
-    allocateMemory(stack, BLOCK_STRING, "message", 50);
-    char msg[] = "Hello from function";
-    setTopBlockValue(stack, msg);
+    printf("\n=== WORST-CASE LATENCY BENCHMARK ===\n");
+    printf("%ld operations per pattern, seed %u (latencies include the clock read)\n", operations, seed);
+    printf("%-15s %-8s %10s %8s %8s %9s %10s %8s\n", "Pattern", "Engine", "Ops/sec", "p50 ns", "p99 ns",
+           "p99.9 ns", "p100 ns", "Failed");
     
-    printf("Function %s is executing with local variables:\n", functionName);
-    displayMemoryStack(stack);
+    for (int pattern = 0; pattern < 3; pattern++) {
+        AllocationTrace* trace;
+        switch (pattern) {
+            case 0: trace = generateChurnTrace(operations, 4096, seed); break;
+            case 1: trace = generateSplitCoalesceTrace(operations); break;
+            default: trace = generateSawtoothTrace(operations, seed); break;
+        }
+        
+        for (int engine = 0; engine < REPLAY_ENGINE_COUNT; engine++) {
+            ReplayResult result = replayAllocationTrace(trace, (ReplayEngine)engine);
+            if (result.operations == 0) {
+                continue;
+            }
+            printf("%-15s %-8s %10.0f %8.0f %8.0f %9.0f %10.0f %8ld\n", patternNames[pattern],
+                   getReplayEngineName((ReplayEngine)engine), result.operations / (result.elapsedNs / 1e9),
+                   result.p50Ns, result.p99Ns, result.p999Ns, result.maxNs, result.failedAllocations);
+        }
+        freeAllocationTrace(trace);
+    }
+    printf("The stack mode is left out: it only frees in LIFO order.\n");
+    printf("====================================\n");
+}
+
+// Function to generate a mixed-lifetime trace: a quarter of the slots hold
+// small long-lived objects that are rarely freed, the rest churn through
+// small and large short-lived objects, so long-lived objects pin the holes
+AllocationTrace* generateMixedLifetimeTrace(long operations, int liveSlots, unsigned int seed) {
+    AllocationTrace* trace = createAllocationTrace();
+    unsigned int* slots = (unsigned int*)calloc(liveSlots, sizeof(unsigned int));
+    unsigned int rngState = seed != 0 ? seed : 1;
     
-    printf("Function %s completed. Cleaning up local variables...\n", functionName);
+    for (long op = 0; op < operations; op++) {
+        int slot = (int)(nextRandom(&rngState) % liveSlots);
+        int longLived = slot < liveSlots / 4;
+        
+        if (slots[slot] != 0) {
+            if (!longLived || nextRandom(&rngState) % 32 == 0) {
+                appendTraceRecord(trace, TRACE_FREE, slots[slot], 0, 1);
+                slots[slot] = 0;
+            }
+        } else {
+            size_t size;
+            if (longLived) {
+                size = 16 + nextRandom(&rngState) % 48;
+            } else if (nextRandom(&rngState) % 8 == 0) {
+                size = 1024 + nextRandom(&rngState) % 3072;
+            } else {
+                size = 16 + nextRandom(&rngState) % 496;
+            }
+            slots[slot] = trace->nextLifetimeId++;
+            appendTraceRecord(trace, TRACE_ALLOC, slots[slot], size, BLOCK_ALIGNMENT);
+        }
+    }
     
-    // Clean up local variables (simulate function return)
-    deallocateMemory(stack); // message
-    deallocateMemory(stack); // localVar2
-    deallocateMemory(stack); // localVar1
+    for (int i = 0; i < liveSlots; i++) {
+        if (slots[i] != 0) {
+            appendTraceRecord(trace, TRACE_FREE, slots[i], 0, 1);
+        }
+    }
     
-    printf("Stack frame for %s cleaned up.\n", functionName);
+    free(slots);
+    return trace;
 }
 
-// Function to simulate nested function calls
-void simulateNestedCalls(MemoryStack* stack) {
-    printf("\n=== SIMULATING NESTED FUNCTION CALLS ===\n");
-    
-    // Main function variables
-    allocateMemory(stack, BLOCK_INT, "mainVar", sizeof(int));
-    int mainVal = 100;
-    setTopBlockValue(stack, &mainVal);
+// Function to benchmark the compacting heap against TLSF on a mixed-lifetime
+// trace. Both get the same tight region (the peak block bytes plus 12.5%); the
+// compacting heap runs one slice of at most sliceNs every
+// COMPACT_SLICE_INTERVAL operations.
+void benchmarkCompactingHeap(long operations, int liveSlots, double sliceNs, unsigned int seed) {
+    AllocationTrace* trace = generateMixedLifetimeTrace(operations, liveSlots, seed);
+    size_t* sizes = (size_t*)calloc(trace->nextLifetimeId, sizeof(size_t));
+    void** objects = (void**)calloc(trace->nextLifetimeId, sizeof(void*));
+    MemoryHandle* handles = (MemoryHandle*)calloc(trace->nextLifetimeId, sizeof(MemoryHandle));
+    if (sizes == NULL || objects == NULL || handles == NULL) {
+        printf("Error: Not enough memory to replay %zu records\n", trace->count);
+        freeAllocationTrace(trace);
+        free(handles);
+        free(objects);
+        free(sizes);
+        return;
+    }
     
-    printf("Main function started.\n");
-    displayMemoryStack(stack);
+    // Both heaps use 16-byte headers and 16-byte rounding, so one peak fits both
+    size_t blockBytes = 0, peakBlockBytes = 0;
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        if (record->op == TRACE_ALLOC) {
+            sizes[record->lifetimeId] = record->size;
+            blockBytes += COMPACT_HEADER_SIZE + alignUp(record->size, BLOCK_ALIGNMENT);
+            if (blockBytes > peakBlockBytes) {
+                peakBlockBytes = blockBytes;
+            }
+        } else {
+            blockBytes -= COMPACT_HEADER_SIZE + alignUp(sizes[record->lifetimeId], BLOCK_ALIGNMENT);
+        }
+    }
+    size_t capacity = peakBlockBytes + peakBlockBytes / 8;
     
-    // First function call
-    printf("\nCalling function A...\n");
-    allocateMemory(stack, BLOCK_FLOAT, "functionA_var", sizeof(float));
-    float aVal = 1.5f;
-    setTopBlockValue(stack, &aVal);
+    TlsfAllocator* tlsf = createTlsfAllocator(capacity);
+    double tlsfBegin = currentTimeNs();
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        if (record->op == TRACE_ALLOC) {
+            objects[record->lifetimeId] = tlsfAlloc(tlsf, record->size);
+        } else if (objects[record->lifetimeId] != NULL) {
+            tlsfFree(tlsf, objects[record->lifetimeId], sizes[record->lifetimeId]);
+        }
+    }
+    double tlsfNs = currentTimeNs() - tlsfBegin;
     
-    // Second function call (nested)
-    printf("\nCalling function B from A...\n");
-    allocateMemory(stack, BLOCK_CHAR, "functionB_var", sizeof(char));
-    char bVal = 'X';
-    setTopBlockValue(stack, &bVal);
+    CompactingHeap* heap = createCompactingHeap(capacity);
+    double compactBegin = currentTimeNs();
+    for (size_t i = 0; i < trace->count; i++) {
+        TraceRecord* record = &trace->records[i];
+        if (record->op == TRACE_ALLOC) {
+            handles[record->lifetimeId] = compactAlloc(heap, record->size);
+        } else {
+            compactFree(heap, handles[record->lifetimeId]);
+        }
+        if (i % COMPACT_SLICE_INTERVAL == COMPACT_SLICE_INTERVAL - 1) {
+            compactIfNeeded(heap, sliceNs);
+        }
+    }
+    double compactNs = currentTimeNs() - compactBegin;
     
-    printf("\nCurrent stack state (nested calls):\n");
-    displayMemoryStack(stack);
+    printf("\n=== COMPACTING HEAP BENCHMARK ===\n");
+    printf("%zu operations on %d slots, region %zu bytes (peak block bytes %zu + 12.5%%), seed %u\n",
+           trace->count, liveSlots, capacity, peakBlockBytes, seed);
+    printf("%-12s %12s %10s\n", "Heap", "Ops/sec", "Failed");
+    printf("%-12s %12.0f %10ld\n", "tlsf", trace->count / (tlsfNs / 1e9), tlsf->failedAllocations);
+    printf("%-12s %12.0f %10ld\n", "compacting", trace->count / (compactNs / 1e9), heap->failedAllocations);
+    printf("\nCompactor (slices of at most %.0f ns every %d operations):\n", sliceNs, COMPACT_SLICE_INTERVAL);
+    printf("Cycles: %ld, slices: %ld, full compactions: %ld\n", heap->cycles, heap->slices, heap->fullCompactions);
+    printf("Bytes moved: %zu, bytes reclaimed: %zu\n", heap->bytesMoved, heap->bytesReclaimed);
+    printf("Pause times: p50 %llu ns, p99 %llu ns, p99.9 %llu ns, max %llu ns\n",
+           getHistogramPercentile(&heap->pauses, 50), getHistogramPercentile(&heap->pauses, 99),
+           getHistogramPercentile(&heap->pauses, 99.9), heap->pauses.maxNs);
+    printf("=================================\n");
     
-    // Return from function B
-    printf("\nReturning from function B...\n");
-    deallocateMemory(stack);
+    freeCompactingHeap(heap);
+    freeTlsfAllocator(tlsf);
+    freeAllocationTrace(trace);
+    free(handles);
+    free(objects);
+    free(sizes);
+}
+
+// Function to replay a trace against every engine and print a comparison
+void replayTraceReport(AllocationTrace* trace) {
+    printf("\n=== ALLOCATION TRACE REPLAY ===\n");
+    printf("%zu records, %u allocations\n", trace->count, trace->nextLifetimeId - 1);
+    printf("%-8s %12s %8s %8s %8s %8s %10s %12s %8s %8s\n", "Engine", "Ops/sec", "p50 ns", "p90 ns",
+           "p99 ns", "p99.9 ns", "max ns", "Peak RSS KB", "Frag", "Failed");
     
-    // Return from function A
-    printf("\nReturning from function A...\n");
-    deallocateMemory(stack);
+    for (int engine = 0; engine < REPLAY_ENGINE_COUNT; engine++) {
+        ReplayResult result = replayAllocationTrace(trace, (ReplayEngine)engine);
+        char fragmentation[16] = "n/a";
+        if (result.operations == 0) {
+            continue;
+        }
+        
+        if (result.peakFootprint > 0) {
+            snprintf(fragmentation, sizeof(fragmentation), "%.1f%%",
+                     (float)(result.peakFootprint - result.peakLiveBytes) / result.peakFootprint * 100);
+        }
+        printf("%-8s %12.0f %8.0f %8.0f %8.0f %8.0f %10.0f %12zu %8s %8ld\n",
+               getReplayEngineName((ReplayEngine)engine), result.operations / (result.elapsedNs / 1e9),
+               result.p50Ns, result.p90Ns, result.p99Ns, result.p999Ns, result.maxNs,
+               result.peakRssDelta / 1024, fragmentation, result.failedAllocations);
+    }
+    printf("Latencies include the clock read (~20-50 ns); Frag is the share of allocator bytes not requested, at peak.\n");
+    printf("===============================\n");
+}
+
+// Function to display the allocator profile: latency percentiles per
+// operation, the per-type breakdown of the stack and the timeline size
+void displayAllocatorProfile(AllocatorProfile* profile) {
+    printf("\n=== ALLOCATOR PROFILE ===\n");
+    printf("%-14s %10s %8s %8s %8s %8s %9s %10s %9s\n", "Operation", "Count", "min ns", "p50 ns",
+           "p90 ns", "p99 ns", "p99.9 ns", "max ns", "mean ns");
+    for (int op = 0; op < PROFILE_OP_COUNT; op++) {
+        LatencyHistogram* histogram = &profile->histograms[op];
+        if (histogram->totalCount == 0) {
+            continue;
+        }
+        printf("%-14s %10ld %8llu %8llu %8llu %8llu %9llu %10llu %9.0f\n", getProfileOpName((ProfileOp)op),
+               histogram->totalCount, histogram->minNs, getHistogramPercentile(histogram, 50),
+               getHistogramPercentile(histogram, 90), getHistogramPercentile(histogram, 99),
+               getHistogramPercentile(histogram, 99.9), histogram->maxNs,
+               histogram->sumNs / histogram->totalCount);
+    }
     
-    printf("\nBack in main function:\n");
-    displayMemoryStack(stack);
+    printf("\nStack usage by block type:\n");
+    printf("%-8s %12s %8s %10s %10s %10s\n", "Type", "Allocations", "Live", "Live bytes", "Peak bytes", "Padding");
+    for (int type = 0; type < BLOCK_TYPE_COUNT; type++) {
+        BlockTypeStats* stats = &profile->types[type];
+        printf("%-8s %12ld %8d %10zu %10zu %10zu\n", getBlockTypeString((BlockType)type), stats->allocations,
+               stats->liveBlocks, stats->liveBytes, stats->peakBytes, stats->paddingBytes);
+    }
     
-    // Clean up main
-    deallocateMemory(stack);
-    printf("\nMain function completed.\n");
+    printf("\nTimeline: %zu samples (one per %d operations on an allocator) over %.1f ms\n",
+           profile->timelineCount, PROFILE_SAMPLE_INTERVAL, (currentTimeNs() - profile->startNs) / 1e6);
+    printf("=========================\n");
 }
 
-// Function to demonstrate memory leak detection
-void demonstrateMemoryLeak(MemoryStack* stack) {
-    printf("\n=== MEMORY LEAK DEMONSTRATION ===\n");
+// Function to export the profile as three CSV files: <prefix>_latency.csv
+// (non-empty histogram buckets), <prefix>_timeline.csv and <prefix>_types.csv
+int exportAllocatorProfileCsv(AllocatorProfile* profile, const char* prefix) {
+    char path[300];
+    FILE* file;
     
-    printf("Allocating memory without proper cleanup...\n");
+    snprintf(path, sizeof(path), "%s_latency.csv", prefix);
+    if ((file = fopen(path, "w")) == NULL) {
+        printf("Error: Cannot open '%s' for writing\n", path);
+        return 0;
+    }
+    fprintf(file, "operation,bucket_low_ns,bucket_high_ns,count\n");
+    for (int op = 0; op < PROFILE_OP_COUNT; op++) {
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+            if (profile->histograms[op].counts[bucket] > 0) {
+                fprintf(file, "%s,%llu,%llu,%ld\n", getProfileOpName((ProfileOp)op), getHistogramBucketLow(bucket),
+                        getHistogramBucketHigh(bucket), profile->histograms[op].counts[bucket]);
+            }
+        }
+    }
+    fclose(file);
     
-    allocateMemory(stack, BLOCK_ARRAY, "leakyArray1", 50);
-    allocateMemory(stack, BLOCK_STRING, "leakyString", 30);
-    allocateMemory(stack, BLOCK_INT, "leakyInt", sizeof(int));
+    snprintf(path, sizeof(path), "%s_timeline.csv", prefix);
+    if ((file = fopen(path, "w")) == NULL) {
+        printf("Error: Cannot open '%s' for writing\n", path);
+        return 0;
+    }
+    fprintf(file, "time_ms,allocator,bytes,blocks\n");
+    for (size_t i = 0; i < profile->timelineCount; i++) {
+        TimelineSample* sample = &profile->timeline[i];
+        fprintf(file, "%.3f,%s,%zu,%d\n", sample->timeMs, getProfileAllocatorName((ProfileOp)sample->allocator),
+                sample->bytes, sample->blocks);
+    }
+    fclose(file);
     
-    printf("Current memory usage:\n");
-    displayMemoryStats(stack);
+    snprintf(path, sizeof(path), "%s_types.csv", prefix);
+    if ((file = fopen(path, "w")) == NULL) {
+        printf("Error: Cannot open '%s' for writing\n", path);
+        return 0;
+    }
+    fprintf(file, "type,allocations,live_blocks,live_bytes,peak_bytes,padding_bytes\n");
+    for (int type = 0; type < BLOCK_TYPE_COUNT; type++) {
+        BlockTypeStats* stats = &profile->types[type];
+        fprintf(file, "%s,%ld,%d,%zu,%zu,%zu\n", getBlockTypeString((BlockType)type), stats->allocations,
+                stats->liveBlocks, stats->liveBytes, stats->peakBytes, stats->paddingBytes);
+    }
+    fclose(file);
+    return 1;
+}
+
+// Function to export the whole profile as one JSON document
+int exportAllocatorProfileJson(AllocatorProfile* profile, const char* path) {
+    FILE* file = fopen(path, "w");
+    if (file == NULL) {
+        printf("Error: Cannot open '%s' for writing\n", path);
+        return 0;
+    }
     
-    printf("Simulating program exit without cleanup...\n");
-    printf("Memory leak detected: %zu bytes not freed!\n", stack->totalMemoryUsed);
+    fprintf(file, "{\n  \"operations\": [");
+    int first = 1;
+    for (int op = 0; op < PROFILE_OP_COUNT; op++) {
+        LatencyHistogram* histogram = &profile->histograms[op];
+        if (histogram->totalCount == 0) {
+            continue;
+        }
+        fprintf(file, "%s\n    {\"name\": \"%s\", \"count\": %ld, \"min_ns\": %llu, \"p50_ns\": %llu, "
+                "\"p90_ns\": %llu, \"p99_ns\": %llu, \"p999_ns\": %llu, \"max_ns\": %llu, \"mean_ns\": %.1f, "
+                "\"buckets\": [", first ? "" : ",", getProfileOpName((ProfileOp)op), histogram->totalCount,
+                histogram->minNs, getHistogramPercentile(histogram, 50), getHistogramPercentile(histogram, 90),
+                getHistogramPercentile(histogram, 99), getHistogramPercentile(histogram, 99.9), histogram->maxNs,
+                histogram->sumNs / histogram->totalCount);
+        int firstBucket = 1;
+        for (int bucket = 0; bucket < HISTOGRAM_BUCKETS; bucket++) {
+            if (histogram->counts[bucket] > 0) {
+                fprintf(file, "%s[%llu, %ld]", firstBucket ? "" : ", ", getHistogramBucketLow(bucket),
+                        histogram->counts[bucket]);
+                firstBucket = 0;
+            }
+        }
+        fprintf(file, "]}");
+        first = 0;
+    }
     
-    printf("Proper cleanup:\n");
-    while (!isMemoryStackEmpty(stack)) {
-        deallocateMemory(stack);
+    fprintf(file, "\n  ],\n  \"block_types\": [");
+    for (int type = 0; type < BLOCK_TYPE_COUNT; type++) {
+        BlockTypeStats* stats = &profile->types[type];
+        fprintf(file, "%s\n    {\"type\": \"%s\", \"allocations\": %ld, \"live_blocks\": %d, \"live_bytes\": %zu, "
+                "\"peak_bytes\": %zu, \"padding_bytes\": %zu}", type == 0 ? "" : ",",
+                getBlockTypeString((BlockType)type), stats->allocations, stats->liveBlocks, stats->liveBytes,
+                stats->peakBytes, stats->paddingBytes);
     }
     
-    printf("All memory cleaned up.\n");
+    fprintf(file, "\n  ],\n  \"timeline\": [");
+    for (size_t i = 0; i < profile->timelineCount; i++) {
+        TimelineSample* sample = &profile->timeline[i];
+        fprintf(file, "%s\n    {\"time_ms\": %.3f, \"allocator\": \"%s\", \"bytes\": %zu, \"blocks\": %d}",
+                i == 0 ? "" : ",", sample->timeMs, getProfileAllocatorName((ProfileOp)sample->allocator),
+                sample->bytes, sample->blocks);
+    }
+    fprintf(file, "\n  ]\n}\n");
+    
+    fclose(file);
+    return 1;
 }
 
 // Function to free entire memory stack
@@ -379,16 +3832,88 @@ void freeMemoryStack(MemoryStack* stack) {
     while (!isMemoryStackEmpty(stack)) {
         deallocateMemory(stack);
     }
+    
+    if (stack->virtualArena) {
+#ifdef _WIN32
+        VirtualFree(stack->arena, 0, MEM_RELEASE);
+#else
+        if (guardedStack == stack) {
+            guardedStack = NULL;
+        }
+        munmap(stack->arena, stack->arenaSize);
+#endif
+    } else {
+        free(stack->arena);
+    }
     free(stack);
 }
 
+// Function to demonstrate the virtual stack: lazy page use, release of deep
+// frames back to the OS, and an overflow caught by the guard page
+void demonstrateVirtualStack() {
+    size_t pageSize = getPageSize();
+    MemoryStack* stack = createVirtualMemoryStack(VSTACK_RELEASE_THRESHOLD * 2, 1);
+    if (stack == NULL) {
+        return;
+    }
+    
+    printf("\n=== VIRTUAL STACK DEMONSTRATION ===\n");
+    printf("Reserved %zu KB plus a guard page; pages are backed only as the stack grows\n", stack->guardOffset >> 10);
+    
+    StackMark mark = markMemoryStack(stack);
+    // Volatile: it changes between sigsetjmp and the guard page's siglongjmp
+    volatile int depth = 0;
+    while (stack->arenaUsed + getArenaBlockSize(MAX_BLOCK_SIZE) + VSTACK_RELEASE_THRESHOLD / 2 < stack->guardOffset) {
+        char name[50];
+        snprintf(name, sizeof(name), "frame%d", ++depth);
+        allocateMemory(stack, BLOCK_ARRAY, name, MAX_BLOCK_SIZE);
+    }
+    printf("Deep call chain: %d frames, %zu KB touched\n", depth, stack->touchedBytes >> 10);
+    
+    releaseToMark(stack, mark);
+    printf("After returning: %zu KB touched, %ld pages given back to the OS\n",
+           stack->touchedBytes >> 10, stack->pagesReleased);
+    
+#ifndef _WIN32
+    installGuardPageHandler(stack);
+    depth = 0;
+    if (sigsetjmp(guardRecovery, 1) == 0) {
+        guardArmed = 1;
+        for (;;) {
+            char name[50];
+            snprintf(name, sizeof(name), "runaway%d", ++depth);
+            allocateMemory(stack, BLOCK_ARRAY, name, MAX_BLOCK_SIZE);
+        }
+    }
+    printf("Overflow trapped by the guard page at allocation %d (offset %zu, page size %zu); "
+           "no per-allocation bounds check ran\n", depth, stack->arenaUsed, pageSize);
+#else
+    (void)pageSize;
+    printf("Overflow trapping needs POSIX signals; on Windows the guard page ends the program.\n");
+#endif
+    
+    displayMemoryStats(stack);
+    freeMemoryStack(stack);
+}
+
 // Main function with menu-driven interface
 int main() {
     MemoryStack* memStack = createMemoryStack();
-    int choice, intVal, blockType;
+    StackMark emptyMark = markMemoryStack(memStack);
+    SlabHeap* slabHeap = createSlabHeap(SLAB_HEAP_SIZE);
+    BuddyAllocator* buddy = createBuddyAllocator(MAX_STACK_SIZE);
+    TlsfAllocator* tlsf = createTlsfAllocator(SLAB_HEAP_SIZE);
+    CompactingHeap* compactHeap = createCompactingHeap(SLAB_HEAP_SIZE);
+    int choice, intVal, blockType, liveSlots, threadCount, remotePercent;
+    long operations;
+    unsigned int seed;
     float floatVal;
-    char charVal, varName[50], stringVal[100];
-    size_t arraySize;
+    char charVal, varName[50], stringVal[100], traceFile[256];
+    size_t arraySize, alignment;
+    
+#ifdef LEAK_TRACKING
+    leakTracker = createLeakTracker();
+#endif
     
     printf("Welcome to Memory Management Model using Stack!\n");
     printf("Simulate stack-based memory allocation and deallocation!\n\n");
@@ -405,7 +3930,31 @@ int main() {
         printf("8. Simulate nested function calls\n");
         printf("9. Demonstrate memory leak\n");
         printf("10. Clear all memory\n");
-        printf("11. Exit\n");
+        printf("11. Slab heap demo (out-of-order frees)\n");
+        printf("12. Display slab heap statistics\n");
+        printf("13. Benchmark slab heap vs malloc\n");
+        printf("14. Buddy allocator demo\n");
+        printf("15. Display buddy allocator statistics\n");
+        printf("16. Resize buddy pool\n");
+        printf("17. Benchmark thread arenas vs malloc\n");
+        printf("18. Start/stop recording stack allocations to a trace\n");
+        printf("19. Generate synthetic allocation trace file\n");
+        printf("20. Replay allocation trace file\n");
+        printf("21. Toggle leak tracking\n");
+        printf("22. Find block by ID\n");
+        printf("23. Aligned allocation demo (all modes)\n");
+        printf("24. Start/stop allocator profiling\n");
+        printf("25. Display allocator profile\n");
+        printf("26. Export allocator profile (CSV and JSON)\n");
+        printf("27. Switch stack to virtual (reserved range + guard page) mode\n");
+        printf("28. Virtual stack demo (lazy pages, release, guard page)\n");
+        printf("29. TLSF allocator demo\n");
+        printf("30. Display TLSF allocator statistics\n");
+        printf("31. Worst-case latency benchmark (all heap modes)\n");
+        printf("32. Compacting heap demo (handles, incremental compaction)\n");
+        printf("33. Display compacting heap statistics\n");
+        printf("34. Benchmark compacting heap vs TLSF (mixed lifetimes)\n");
+        printf("35. Exit\n");
         printf("Enter your choice: ");
         
         scanf("%d", &choice);
@@ -442,10 +3991,10 @@ int main() {
                         }
                         break;
                     case BLOCK_ARRAY:
-                        printf("Enter array size in bytes: ");
-                        scanf("%zu", &arraySize);
+                        printf("Enter array size in bytes and alignment (16, 32 or 64): ");
+                        scanf("%zu %zu", &arraySize, &alignment);
                         if (arraySize > 0 && arraySize <= MAX_BLOCK_SIZE) {
-                            allocateMemory(memStack, BLOCK_ARRAY, varName, arraySize);
+                            allocateMemoryAligned(memStack, BLOCK_ARRAY, varName, arraySize, alignment);
                         } else {
                             printf("Invalid size!\n");
                         }
@@ -519,21 +4068,266 @@ int main() {
                 break;
                 
             case 10:
-                while (!isMemoryStackEmpty(memStack)) {
-                    deallocateMemory(memStack);
-                }
+                releaseToMark(memStack, emptyMark);
                 printf("All memory cleared!\n");
                 break;
                 
             case 11:
+                demonstrateSlabHeap(slabHeap);
+                break;
+                
+            case 12:
+                displaySlabHeapStats(slabHeap);
+                break;
+                
+            case 13:
+                printf("Enter live object slots, operations and random seed: ");
+                scanf("%d %ld %u", &liveSlots, &operations, &seed);
+                
+                if (liveSlots > 0 && operations > 0) {
+                    benchmarkSlabHeap(liveSlots, operations, seed);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 14:
+                demonstrateBuddyAllocator(buddy);
+                break;
+                
+            case 15:
+                displayBuddyStats(buddy);
+                break;
+                
+            case 16:
+                if (buddy->totalBlocks > 0) {
+                    printf("Buddy pool still has %d live blocks!\n", buddy->totalBlocks);
+                    break;
+                }
+                printf("Enter buddy pool capacity in bytes (rounded up to a power of two): ");
+                scanf("%zu", &arraySize);
+                if (arraySize >= (1 << BUDDY_MIN_ORDER) && arraySize <= ((size_t)1 << 30)) {
+                    freeBuddyAllocator(buddy);
+                    buddy = createBuddyAllocator(arraySize);
+                    printf("Buddy pool resized to %zu bytes\n", buddy->capacity);
+                } else {
+                    printf("Invalid capacity!\n");
+                }
+                break;
+                
+            case 17:
+                printf("Enter max threads, operations per thread, live slots per thread and remote-free percent: ");
+                scanf("%d %ld %d %d", &threadCount, &operations, &liveSlots, &remotePercent);
+                
+                if (threadCount > 0 && operations > 0 && liveSlots > 0 && remotePercent >= 0 && remotePercent <= 100) {
+                    benchmarkThreadArenas(threadCount, operations, liveSlots, remotePercent, 12345);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 18:
+                if (traceRecorder == NULL) {
+                    traceRecorder = createAllocationTrace();
+                    printf("Recording stack allocations; choose 18 again to stop and save.\n");
+                } else {
+                    printf("Enter trace file name: ");
+                    scanf("%255s", traceFile);
+                    if (saveAllocationTrace(traceRecorder, traceFile)) {
+                        printf("Saved %zu records to '%s'\n", traceRecorder->count, traceFile);
+                    }
+                    freeAllocationTrace(traceRecorder);
+                    traceRecorder = NULL;
+                }
+                break;
+                
+            case 19:
+                printf("Enter trace file name, operations, live slots and random seed: ");
+                scanf("%255s %ld %d %u", traceFile, &operations, &liveSlots, &seed);
+                
+                if (operations > 0 && liveSlots > 0) {
+                    AllocationTrace* trace = generateChurnTrace(operations, liveSlots, seed);
+                    if (saveAllocationTrace(trace, traceFile)) {
+                        printf("Saved %zu records to '%s'\n", trace->count, traceFile);
+                    }
+                    freeAllocationTrace(trace);
+                } else {
+                    printf("Invalid trace parameters!\n");
+                }
+                break;
+                
+            case 20:
+                printf("Enter trace file name: ");
+                scanf("%255s", traceFile);
+                {
+                    AllocationTrace* trace = loadAllocationTrace(traceFile);
+                    if (trace != NULL) {
+                        replayTraceReport(trace);
+                        freeAllocationTrace(trace);
+                    }
+                }
+                break;
+                
+            case 21:
+                if (leakTracker == NULL) {
+                    leakTracker = createLeakTracker();
+                    leakTrackExistingBlocks(leakTracker, memStack);
+                    printf("Leak tracking on: new blocks are indexed with their allocation site.\n");
+                    if (leakTracker->count > 0) {
+                        printf("%zu blocks already live were indexed without a site.\n", leakTracker->count);
+                    }
+                } else {
+                    reportLeaks(leakTracker);
+                    freeLeakTracker(leakTracker);
+                    leakTracker = NULL;
+                    printf("Leak tracking off.\n");
+                }
+                break;
+                
+            case 22:
+                printf("Enter block ID: ");
+                scanf("%d", &intVal);
+                {
+                    MemoryBlock* block = findMemoryBlock(memStack, intVal);
+                    if (block != NULL) {
+                        printf("Block %d: %s variable '%s', %zu bytes at %p\n", block->blockId,
+                               getBlockTypeString(block->type), block->variableName, block->size, block->data);
+                    } else {
+                        printf("Block %d is not live!\n", intVal);
+                    }
+                }
+                break;
+                
+            case 23:
+                demonstrateAlignedAllocation(memStack, slabHeap, buddy);
+                break;
+                
+            case 24:
+                if (allocatorProfile == NULL) {
+                    allocatorProfile = createAllocatorProfile();
+                    printf("Profiling on: allocator operations are timed and sampled.\n");
+                } else {
+                    freeAllocatorProfile(allocatorProfile);
+                    allocatorProfile = NULL;
+                    printf("Profiling off.\n");
+                }
+                break;
+                
+            case 25:
+                if (allocatorProfile != NULL) {
+                    displayAllocatorProfile(allocatorProfile);
+                } else {
+                    printf("Profiling is off!\n");
+                }
+                break;
+                
+            case 26:
+                if (allocatorProfile == NULL) {
+                    printf("Profiling is off!\n");
+                    break;
+                }
+                printf("Enter file name prefix: ");
+                scanf("%250s", traceFile);
+                if (exportAllocatorProfileCsv(allocatorProfile, traceFile)) {
+                    char jsonPath[300];
+                    snprintf(jsonPath, sizeof(jsonPath), "%s.json", traceFile);
+                    if (exportAllocatorProfileJson(allocatorProfile, jsonPath)) {
+                        printf("Wrote %s_latency.csv, %s_timeline.csv, %s_types.csv and %s\n",
+                               traceFile, traceFile, traceFile, jsonPath);
+                    }
+                }
+                break;
+                
+            case 27:
+                if (!isMemoryStackEmpty(memStack)) {
+                    printf("Stack still has %d live blocks!\n", memStack->totalBlocks);
+                    break;
+                }
+                printf("Enter reservation in MB and 1 to return freed pages to the OS (0 to keep them): ");
+                scanf("%zu %d", &arraySize, &intVal);
+                if (arraySize > 0) {
+                    MemoryStack* virtualStack = createVirtualMemoryStack(arraySize << 20, intVal);
+                    if (virtualStack != NULL) {
+                        freeMemoryStack(memStack);
+                        memStack = virtualStack;
+                        emptyMark = markMemoryStack(memStack);
+#ifndef _WIN32
+                        installGuardPageHandler(memStack);
+#endif
+                        printf("Stack now uses a %zu MB virtual range with a guard page\n", arraySize);
+                    }
+                } else {
+                    printf("Invalid reservation!\n");
+                }
+                break;
+                
+            case 28:
+                demonstrateVirtualStack();
+#ifndef _WIN32
+                if (memStack->virtualArena) {
+                    installGuardPageHandler(memStack);
+                }
+#endif
+                break;
+                
+            case 29:
+                demonstrateTlsfAllocator(tlsf);
+                break;
+                
+            case 30:
+                displayTlsfStats(tlsf);
+                break;
+                
+            case 31:
+                printf("Enter operations per pattern and random seed: ");
+                scanf("%ld %u", &operations, &seed);
+                
+                if (operations > 0) {
+                    benchmarkWorstCaseLatency(operations, seed);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 32:
+                demonstrateCompactingHeap(compactHeap);
+                break;
+                
+            case 33:
+                displayCompactingStats(compactHeap);
+                break;
+                
+            case 34:
+                printf("Enter operations, live slots, slice length in microseconds and random seed: ");
+                scanf("%ld %d %d %u", &operations, &liveSlots, &intVal, &seed);
+                
+                if (operations > 0 && liveSlots >= 4 && intVal > 0) {
+                    benchmarkCompactingHeap(operations, liveSlots, intVal * 1000.0, seed);
+                } else {
+                    printf("Invalid benchmark parameters!\n");
+                }
+                break;
+                
+            case 35:
                 printf("Thanks for using Memory Management Model!\n");
                 break;
                 
             default:
                 printf("Invalid choice! Please try again.\n");
         }
-    } while (choice != 11);
+    } while (choice != 35);
     
+    // Shutdown leak report, before the stack is torn down
+    if (leakTracker != NULL) {
+        reportLeaks(leakTracker);
+    }
+    freeAllocationTrace(traceRecorder);
+    freeCompactingHeap(compactHeap);
+    freeTlsfAllocator(tlsf);
+    freeBuddyAllocator(buddy);
+    freeSlabHeap(slabHeap);
     freeMemoryStack(memStack);
+    freeLeakTracker(leakTracker);
+    freeAllocatorProfile(allocatorProfile);
     return 0;
 }
\ No newline at end of file
@@ -7,12 +7,45 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdarg.h>
+#include <math.h>
 #include <time.h>
+#include <stdint.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#ifdef _WIN32
+#include <io.h>
+#else
+#include <unistd.h>
+#endif
 
 #define MAX_NAME_LENGTH 50
 #define MAX_EVENT_NAME 40
 #define MAX_LOCATION_NAME 30
-#define MAX_QUEUE_SIZE 200
+#define DEFAULT_QUEUE_CAPACITY 0 // Waiting reservations allowed; 0 means unbounded
+#define INITIAL_COUNTER_CAPACITY 8
+#define PRIORITY_LEVELS 5 // Per-priority arrays are indexed by PriorityLevel (slot 0 unused)
+#define RESERVATION_TYPES 6 // Per-type arrays are indexed by ReservationType (slot 0 unused)
+#define FLAT_MINUTES_PER_RESERVATION 4
+#define MIN_SERVICE_MINUTES 0.5f // Floor on a counter's average so its service rate stays finite
+#define INDEX_INITIAL_CAPACITY 256 // Slots in the reservation ID index (power of two)
+#define INDEX_FINISHED_HISTORY 1024 // Finished reservations the index still reports
+#define DETAILS_CHUNK_SIZE 256     // Cold records allocated together in the side table
+#define INTERN_INITIAL_CAPACITY 64 // Slots in the string intern table (power of two)
+#define SIM_EMERGENCY_PERCENT 2  // Priority mix of simulated Poisson arrivals
+#define SIM_VIP_PERCENT 8
+#define SIM_PREMIUM_PERCENT 20
+#define MPMC_RING_SIZE 16384     // Slots per priority ring in concurrent mode (power of two)
+#define CONCURRENT_BLOCK_TIMEOUT_MS 1000 // How long the benchmark's intake threads wait on a full ring
+#define CACHE_LINE_SIZE 64
+#define JOURNAL_MAGIC 0x4C4E4A52U  // "RJNL"
+#define JOURNAL_VERSION 1
+#define JOURNAL_HEADER_BYTES 8     // Magic and version
+#define JOURNAL_RECORD_HEADER_BYTES 8 // Payload length and checksum
+#define JOURNAL_MAX_PAYLOAD 512
+#define DEFAULT_GROUP_COMMIT 64    // Records per fsync
+#define MAX_GROUP_COMMIT 4096      // Caps the commit buffer at about 2 MB
 
 // Enumeration for reservation types
 typedef enum {
@@ -40,25 +73,51 @@ typedef enum {
     PRIORITY_EMERGENCY = 4
 } PriorityLevel;
 
-// Structure to represent a reservation request
-typedef struct Reservation {
-    int reservationId;
+// Enumeration for what a full queue does with a new reservation
+typedef enum {
+    OVERLOAD_REJECT = 1,         // Turn the new reservation away
+    OVERLOAD_SHED_LOWEST = 2,    // Drop the newest waiting reservation of a lower priority
+    OVERLOAD_BLOCK = 3           // Hold the request until space frees up or the timeout passes
+} OverloadPolicy;
+
+// Enumeration for where a reservation currently is
+typedef enum {
+    LOCATION_QUEUED,
+    LOCATION_AT_COUNTER,
+    LOCATION_FINISHED
+} ReservationLocation;
+
+// Structure to represent the cold part of a reservation: customer and
+// ticket details that are only read when a reservation is shown or confirmed
+typedef struct ReservationDetails {
     char customerName[MAX_NAME_LENGTH];
     char email[MAX_NAME_LENGTH];
     char phoneNumber[20];
-    ReservationType type;
-    char eventName[MAX_EVENT_NAME];
-    char location[MAX_LOCATION_NAME];
     char dateTime[30];
+    const char* eventName;       // Interned: shared by every reservation for the event
+    const char* location;        // Interned
     int numberOfTickets;
     float totalAmount;
-    PriorityLevel priority;
-    TicketStatus status;
+    struct ReservationDetails* nextFree; // Free list link in the side table
+} ReservationDetails;
+
+// Structure to represent a reservation request. Only the fields the
+// scheduler reads are kept here, so walking the queue stays in cache;
+// everything else is in the cold details.
+typedef struct Reservation {
+    int reservationId;
+    int estimatedWaitTime; // in minutes
+    unsigned char type;          // ReservationType
+    unsigned char priority;      // PriorityLevel
+    unsigned char status;        // TicketStatus
     time_t requestTime;
     time_t processTime;
     time_t confirmationTime;
-    int estimatedWaitTime; // in minutes
     struct Reservation* next;
+    struct Reservation* prev;
+    struct Reservation* typeNext; // Links among waiting reservations of the same type and priority
+    struct Reservation* typePrev;
+    ReservationDetails* details;
 } Reservation;
 
 // Structure to represent a service counter
@@ -73,20 +132,232 @@ typedef struct Counter {
     ReservationType specialization; // 0 for all types
 } Counter;
 
-// Structure to represent the reservation queue system
+// One slot of the reservation ID index (reservationId 0 marks an empty slot).
+// Finished reservations are freed, so their slot keeps only the final status.
+typedef struct IndexEntry {
+    int reservationId;
+    ReservationLocation location;
+    int counterId;               // Counter holding it while LOCATION_AT_COUNTER
+    TicketStatus status;         // Final status once LOCATION_FINISHED
+    Reservation* reservation;    // NULL once LOCATION_FINISHED
+} IndexEntry;
+
+// Structure to represent the open-addressing index from reservationId to
+// each reservation and its location. Only the last INDEX_FINISHED_HISTORY
+// finished reservations are kept, so the table tracks the live queue size.
+typedef struct ReservationIndex {
+    IndexEntry* entries;
+    int capacity;                // Power of two
+    int count;
+    int* finishedIds;            // Ring of finished IDs, oldest at finishedHead
+    int finishedHead;
+    int finishedCount;
+} ReservationIndex;
+
+// Structure to represent the side table of cold reservation details:
+// chunks of DETAILS_CHUNK_SIZE records whose free ones are linked together
+typedef struct ReservationDetailsTable {
+    ReservationDetails** chunks;
+    int chunkCount;
+    int chunkCapacity;
+    ReservationDetails* freeList;
+    int live;
+} ReservationDetailsTable;
+
+// Structure to represent the open-addressing set of interned strings.
+// Each distinct string is stored once and lives as long as the queue.
+typedef struct StringInternTable {
+    char** slots;                // NULL marks an empty slot
+    int capacity;                // Power of two
+    int count;
+} StringInternTable;
+
+// Enumeration for the kinds of journal record
+typedef enum {
+    JOURNAL_COUNTER_ADDED = 1,
+    JOURNAL_CREATED = 2,
+    JOURNAL_PROCESSED = 3,
+    JOURNAL_CONFIRMED = 4,
+    JOURNAL_CANCELLED = 5,       // Counter 0: shed from the queue
+    JOURNAL_TOTALS = 6           // Queue totals and next ID, closing a snapshot
+} JournalRecordKind;
+
+// Structure to represent the append-only journal of reservation events.
+// Records collect in the buffer and reach the disk together, with one
+// fsync per group commit.
+typedef struct ReservationJournal {
+    FILE* file;
+    char path[256];
+    unsigned char* buffer;
+    size_t bufferUsed;
+    int groupCommitRecords;      // Records per commit (1 syncs every record)
+    int pendingRecords;          // Buffered since the last commit
+    long recordsWritten;
+    long long bytesWritten;
+    long commits;
+    double commitSeconds;        // Time spent writing and syncing
+    int broken;                  // A commit failed: nothing more is appended
+} ReservationJournal;
+
+// Results of replaying a journal
+typedef struct JournalRecoveryStats {
+    long records;
+    long inconsistent;           // Records that did not match the rebuilt state
+    long long validBytes;        // Where the intact journal ends
+    long long discardedBytes;    // Torn or corrupt tail after validBytes
+    double seconds;
+} JournalRecoveryStats;
+
+// Structure to represent the reservation queue system.
+// The queue is one doubly linked list ordered by priority; each priority
+// level occupies a contiguous band whose ends are kept in bandHead/bandTail.
+// The reservations of each type and priority are also linked in the same
+// order, so specialized counters find their next match without a scan.
 typedef struct ReservationQueue {
     Reservation* front;
     Reservation* rear;
+    Reservation* bandHead[PRIORITY_LEVELS];
+    Reservation* bandTail[PRIORITY_LEVELS];
+    Reservation* typeHead[RESERVATION_TYPES][PRIORITY_LEVELS];
+    Reservation* typeTail[RESERVATION_TYPES][PRIORITY_LEVELS];
+    int bandCount[PRIORITY_LEVELS];
+    double serviceRate;     // Reservations per minute over all active counters
+    int useServiceRate;     // 1: estimate waits from serviceRate, 0: flat 4 minutes each
+    ReservationIndex index;
+    ReservationDetailsTable details;
+    StringInternTable strings;   // Event names and locations
     int size;
     int nextReservationId;
-    Counter counters[15];
+    Counter* counters;
     int counterCount;
+    int counterCapacity;
+    int capacity;                // Waiting reservations allowed (0 = unbounded)
+    OverloadPolicy overloadPolicy;
+    double blockTimeoutMinutes;
     int totalReservations;
     int totalConfirmed;
     int totalCancelled;
     float totalRevenue;
+    int totalRejected;           // Turned away because the queue was full
+    int totalShed;               // Dropped from the queue to make room for higher priority
+    int totalBlocked;            // Held back by OVERLOAD_BLOCK
+    int totalBlockTimeouts;      // Blocked requests given up after the timeout
+    double totalBlockedMinutes;
+    ReservationJournal* journal; // NULL unless journaling
 } ReservationQueue;
 
+// Parameters of a load simulation
+typedef struct SimulationConfig {
+    double arrivalsPerMinute;    // Poisson arrival rate
+    double meanServiceMinutes;   // Mean of the exponential service time
+    double durationMinutes;      // Arrivals stop after this; the queue then drains
+    unsigned int seed;
+} SimulationConfig;
+
+// One arrival of a trace-driven simulation
+typedef struct SimArrival {
+    double seconds;
+    ReservationType type;
+    PriorityLevel priority;
+} SimArrival;
+
+// A scheduled service completion on the simulator's event heap
+typedef struct SimEvent {
+    double seconds;
+    int counterIndex;
+} SimEvent;
+
+// One slot of a lock-free ring; its sequence says whose turn the slot is
+typedef struct MpmcCell {
+    atomic_size_t sequence;
+    Reservation* reservation;
+} MpmcCell;
+
+// Bounded multi-producer multi-consumer ring (Vyukov). Producers and
+// consumers each claim slots with one CAS on their own cursor; the cursors
+// sit on separate cache lines.
+typedef struct MpmcRing {
+    MpmcCell* cells;
+    size_t mask;
+    char pad0[CACHE_LINE_SIZE];
+    atomic_size_t enqueuePos;
+    char pad1[CACHE_LINE_SIZE];
+    atomic_size_t dequeuePos;
+    char pad2[CACHE_LINE_SIZE];
+} MpmcRing;
+
+// Structure to represent the thread-safe reservation queue: one lock-free
+// FIFO ring per priority level and atomic totals. Intake threads enqueue
+// and counter threads dequeue at the same time.
+typedef struct ConcurrentReservationQueue {
+    MpmcRing rings[PRIORITY_LEVELS];
+    atomic_int nextReservationId;
+    atomic_long totalReservations;
+    atomic_long totalConfirmed;
+    atomic_llong revenueCents;   // totalRevenue in cents, so it can be added atomically
+    atomic_long fullRetries;     // Times an intake thread found its ring full and yielded
+    atomic_long blockTimeouts;   // Submissions given up after blocking for blockTimeoutSeconds
+    double blockTimeoutSeconds;
+} ConcurrentReservationQueue;
+
+// Arguments and results of one intake or counter thread
+typedef struct ConcurrentWorker {
+    ConcurrentReservationQueue* queue;
+    int index;
+    int count;                   // Reservations this intake thread submits
+    int intakeThreads;
+    atomic_int* intakesRunning;  // Counter threads stop once this is 0 and the rings are empty
+    atomic_int* seen;            // Serve count per reservation ID (stress test only)
+    unsigned int seed;
+    long errors;
+    long long submittedCents;
+} ConcurrentWorker;
+
+// Results of a load simulation
+typedef struct SimulationResult {
+    long events;
+    long arrivals;
+    long served;
+    long rejected;
+    long shed;
+    long blocked;
+    long blockTimeouts;
+    double blockedMinutes;
+    int maxQueueLength;
+    double avgQueueLength;       // Time-weighted
+    double simulatedMinutes;
+    double wallSeconds;
+    int* waits[PRIORITY_LEVELS]; // Seconds from request to processing, sorted
+    int waitCounts[PRIORITY_LEVELS];
+    int waitCapacity[PRIORITY_LEVELS];
+    double* busySeconds;         // Per counter
+    int counterCount;
+} SimulationResult;
+
+// Clock every reservation timestamp is read from. The simulator swaps in
+// its virtual clock; interactive use reads the wall clock.
+static time_t (*reservationClock)(void) = NULL;
+
+// Set by the simulator: per-reservation messages are suppressed
+static int quietMode = 0;
+
+// Function to read the current time from the reservation clock
+time_t currentTime() {
+    return reservationClock != NULL ? reservationClock() : time(NULL);
+}
+
+// Function to print a per-reservation message unless running quietly
+void logMessage(const char* format, ...) {
+    if (quietMode) {
+        return;
+    }
+    
+    va_list args;
+    va_start(args, format);
+    vprintf(format, args);
+    va_end(args);
+}
+
 // Function to get reservation type string
 const char* getReservationTypeString(ReservationType type) {
     switch (type) {
@@ -127,13 +398,49 @@ ReservationQueue* createReservationQueue() {
     ReservationQueue* queue = (ReservationQueue*)malloc(sizeof(ReservationQueue));
     queue->front = NULL;
     queue->rear = NULL;
+    for (int level = 0; level < PRIORITY_LEVELS; level++) {
+        queue->bandHead[level] = NULL;
+        queue->bandTail[level] = NULL;
+        queue->bandCount[level] = 0;
+        for (int type = 0; type < RESERVATION_TYPES; type++) {
+            queue->typeHead[type][level] = NULL;
+            queue->typeTail[type][level] = NULL;
+        }
+    }
     queue->size = 0;
     queue->nextReservationId = 1001; // Start from 1001
+    queue->counters = NULL;
     queue->counterCount = 0;
+    queue->counterCapacity = 0;
+    queue->capacity = DEFAULT_QUEUE_CAPACITY;
+    queue->overloadPolicy = OVERLOAD_REJECT;
+    queue->blockTimeoutMinutes = 5.0;
+    queue->totalRejected = 0;
+    queue->totalShed = 0;
+    queue->totalBlocked = 0;
+    queue->totalBlockTimeouts = 0;
+    queue->totalBlockedMinutes = 0.0;
+    queue->journal = NULL;
     queue->totalReservations = 0;
     queue->totalConfirmed = 0;
     queue->totalCancelled = 0;
     queue->totalRevenue = 0.0f;
+    queue->serviceRate = 0.0;
+    queue->useServiceRate = 0;
+    queue->index.capacity = INDEX_INITIAL_CAPACITY;
+    queue->index.count = 0;
+    queue->index.entries = (IndexEntry*)calloc(queue->index.capacity, sizeof(IndexEntry));
+    queue->index.finishedIds = (int*)malloc(INDEX_FINISHED_HISTORY * sizeof(int));
+    queue->index.finishedHead = 0;
+    queue->index.finishedCount = 0;
+    queue->details.chunks = NULL;
+    queue->details.chunkCount = 0;
+    queue->details.chunkCapacity = 0;
+    queue->details.freeList = NULL;
+    queue->details.live = 0;
+    queue->strings.capacity = INTERN_INITIAL_CAPACITY;
+    queue->strings.count = 0;
+    queue->strings.slots = (char**)calloc(queue->strings.capacity, sizeof(char*));
     return queue;
 }
 
@@ -144,479 +451,2220 @@ int isReservationQueueEmpty(ReservationQueue* queue) {
 
 // Function to check if queue is full
 int isReservationQueueFull(ReservationQueue* queue) {
-    return queue->size >= MAX_QUEUE_SIZE;
+    return queue->capacity > 0 && queue->size >= queue->capacity;
 }
 
-// Function to add service counter
-void addCounter(ReservationQueue* queue, char* counterName, char* operatorName, ReservationType specialization) {
-    if (queue->counterCount >= 15) {
-        printf("❌ Maximum number of counters reached!\n");
-        return;
+// Function to get overload policy string
+const char* getOverloadPolicyString(OverloadPolicy policy) {
+    switch (policy) {
+        case OVERLOAD_REJECT: return "Reject";
+        case OVERLOAD_SHED_LOWEST: return "Shed lowest priority";
+        case OVERLOAD_BLOCK: return "Block with timeout";
+        default: return "Unknown";
+    }
+}
+
+// Function to take a cold details record from the side table, adding a
+// chunk when none is free
+ReservationDetails* allocateReservationDetails(ReservationDetailsTable* table) {
+    if (table->freeList == NULL) {
+        if (table->chunkCount == table->chunkCapacity) {
+            table->chunkCapacity = table->chunkCapacity > 0 ? table->chunkCapacity * 2 : 8;
+            table->chunks = (ReservationDetails**)realloc(table->chunks,
+                                                          table->chunkCapacity * sizeof(ReservationDetails*));
+        }
+        ReservationDetails* chunk = (ReservationDetails*)malloc(DETAILS_CHUNK_SIZE * sizeof(ReservationDetails));
+        table->chunks[table->chunkCount++] = chunk;
+        for (int i = DETAILS_CHUNK_SIZE - 1; i >= 0; i--) {
+            chunk[i].nextFree = table->freeList;
+            table->freeList = &chunk[i];
+        }
     }
     
-    Counter* counter = &queue->counters[queue->counterCount];
-    counter->counterId = queue->counterCount + 1;
-    strcpy(counter->counterName, counterName);
-    strcpy(counter->operatorName, operatorName);
-    counter->specialization = specialization;
-    counter->currentReservation = NULL;
-    counter->isActive = 1;
-    counter->totalProcessed = 0;
-    counter->avgProcessingTime = 3.0f; // Default 3 minutes
-    
-    queue->counterCount++;
-    printf("✅ Counter '%s' (ID: %d) with operator '%s' added successfully!\n", 
-           counterName, counter->counterId, operatorName);
-    
-    if (specialization != 0) {
-        printf("   Specialization: %s reservations\n", getReservationTypeString(specialization));
-    } else {
-        printf("   Handles all types of reservations\n");
+    ReservationDetails* details = table->freeList;
+    table->freeList = details->nextFree;
+    table->live++;
+    return details;
+}
+
+// Function to return a cold details record to the side table
+void releaseReservationDetails(ReservationDetailsTable* table, ReservationDetails* details) {
+    details->nextFree = table->freeList;
+    table->freeList = details;
+    table->live--;
+}
+
+// Function to get the hash of a string (FNV-1a)
+unsigned int getStringHash(const char* text) {
+    unsigned int hash = 2166136261U;
+    for (; *text != '\0'; text++) {
+        hash = (hash ^ (unsigned char)*text) * 16777619U;
     }
+    return hash;
 }
 
-// Function to calculate estimated wait time
-int calculateWaitTime(ReservationQueue* queue, PriorityLevel priority) {
-    int position = 0;
-    Reservation* current = queue->front;
-    
-    while (current != NULL) {
-        if (current->priority >= priority) {
-            position++;
+// Function to intern a string: return the one stored copy of it, adding it
+// the first time it is seen. The table doubles at half load.
+const char* internString(StringInternTable* table, const char* text) {
+    unsigned int mask = (unsigned int)table->capacity - 1;
+    unsigned int slot = getStringHash(text) & mask;
+    for (; table->slots[slot] != NULL; slot = (slot + 1) & mask) {
+        if (strcmp(table->slots[slot], text) == 0) {
+            return table->slots[slot];
         }
-        current = current->next;
     }
     
-    // Base wait time calculation
-    int baseTime = position * 4; // 4 minutes per reservation ahead
+    size_t length = strlen(text) + 1;
+    char* copy = (char*)malloc(length);
+    memcpy(copy, text, length);
+    table->slots[slot] = copy;
+    table->count++;
     
-    switch (priority) {
-        case PRIORITY_EMERGENCY: return baseTime * 0.2f;
-        case PRIORITY_VIP: return baseTime * 0.5f;
-        case PRIORITY_PREMIUM: return baseTime * 0.7f;
-        default: return baseTime;
+    if (table->count * 2 > table->capacity) {
+        char** oldSlots = table->slots;
+        int oldCapacity = table->capacity;
+        
+        table->capacity *= 2;
+        mask = (unsigned int)table->capacity - 1;
+        table->slots = (char**)calloc(table->capacity, sizeof(char*));
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldSlots[i] != NULL) {
+                slot = getStringHash(oldSlots[i]) & mask;
+                while (table->slots[slot] != NULL) {
+                    slot = (slot + 1) & mask;
+                }
+                table->slots[slot] = oldSlots[i];
+            }
+        }
+        free(oldSlots);
     }
+    return copy;
 }
 
-// Function to add reservation to queue (priority-based insertion)
-Reservation* addReservation(ReservationQueue* queue, char* customerName, char* email, char* phone,
-                           ReservationType type, char* eventName, char* location, char* dateTime,
-                           int numTickets, float amount, PriorityLevel priority) {
+// Function to free a reservation of the queue together with its cold details
+void freeReservation(ReservationQueue* queue, Reservation* reservation) {
+    releaseReservationDetails(&queue->details, reservation->details);
+    free(reservation);
+}
+
+// Function to read a monotonic clock in seconds (for benchmarks and
+// timeouts, which must not jump when the wall clock is adjusted)
+double readWallSeconds() {
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return (double)now.tv_sec + now.tv_nsec / 1e9;
+}
+
+// Function to write a 32-bit value little-endian (journal files are portable)
+void writeLe32(unsigned char* out, unsigned int value) {
+    out[0] = (unsigned char)value;
+    out[1] = (unsigned char)(value >> 8);
+    out[2] = (unsigned char)(value >> 16);
+    out[3] = (unsigned char)(value >> 24);
+}
+
+// Function to read a 32-bit little-endian value
+unsigned int readLe32(const unsigned char* in) {
+    return (unsigned int)in[0] | ((unsigned int)in[1] << 8) |
+           ((unsigned int)in[2] << 16) | ((unsigned int)in[3] << 24);
+}
+
+// Function to write a 64-bit value little-endian
+void writeLe64(unsigned char* out, long long value) {
+    writeLe32(out, (unsigned int)value);
+    writeLe32(out + 4, (unsigned int)((unsigned long long)value >> 32));
+}
+
+// Function to read a 64-bit little-endian value
+long long readLe64(const unsigned char* in) {
+    return (long long)(readLe32(in) | ((unsigned long long)readLe32(in + 4) << 32));
+}
+
+// Function to get the bit pattern of a float, so amounts replay exactly
+unsigned int getFloatBits(float value) {
+    unsigned int bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return bits;
+}
+
+// Function to get a float back from its bit pattern
+float getFloatFromBits(unsigned int bits) {
+    float value;
+    memcpy(&value, &bits, sizeof(value));
+    return value;
+}
+
+// Function to compute the FNV-1a checksum of a journal record payload
+unsigned int getJournalChecksum(const unsigned char* data, size_t length) {
+    unsigned int hash = 2166136261U;
+    for (size_t i = 0; i < length; i++) {
+        hash = (hash ^ data[i]) * 16777619U;
+    }
+    return hash;
+}
+
+// Function to force a journal file's written data to stable storage
+int syncJournalFile(FILE* file) {
+    if (fflush(file) != 0) {
+        return 0;
+    }
+#ifdef _WIN32
+    return _commit(_fileno(file)) == 0;
+#else
+    return fsync(fileno(file)) == 0;
+#endif
+}
+
+// Function to write the buffered records and sync them: one group commit.
+// A failed commit may leave a partial group in the file, and records
+// appended after it would be lost behind it on replay, so the journal is
+// marked broken and stops taking records.
+int commitJournal(ReservationJournal* journal) {
+    if (journal == NULL) {
+        return 1;
+    }
+    if (journal->broken) {
+        return 0;
+    }
+    if (journal->pendingRecords == 0) {
+        return 1;
+    }
     
-    if (isReservationQueueFull(queue)) {
-        printf("❌ Reservation queue is full! Cannot accept more reservations.\n");
-        return NULL;
+    double begin = readWallSeconds();
+    int ok = fwrite(journal->buffer, 1, journal->bufferUsed, journal->file) == journal->bufferUsed &&
+             syncJournalFile(journal->file);
+    journal->commitSeconds += readWallSeconds() - begin;
+    if (ok) {
+        journal->bytesWritten += journal->bufferUsed;
+        journal->commits++;
+    }
+    journal->bufferUsed = 0;
+    journal->pendingRecords = 0;
+    if (!ok) {
+        journal->broken = 1;
+        printf("⚠️  Writing journal '%s' failed! Journaling stopped; recovery ends at the last commit that "
+               "reached the disk. Close it and open a new journal.\n", journal->path);
+    }
+    return ok;
+}
+
+// Function to append one record (length, checksum, payload), committing
+// the group once it holds groupCommitRecords records. A broken journal
+// drops the record.
+void appendJournalRecord(ReservationJournal* journal, const unsigned char* payload, size_t length) {
+    if (journal->broken) {
+        return;
     }
     
-    Reservation* newReservation = (Reservation*)malloc(sizeof(Reservation));
-    newReservation->reservationId = queue->nextReservationId++;
-    strcpy(newReservation->customerName, customerName);
-    strcpy(newReservation->email, email);
-    strcpy(newReservation->phoneNumber, phone);
-    newReservation->type = type;
-    strcpy(newReservation->eventName, eventName);
-    strcpy(newReservation->location, location);
-    strcpy(newReservation->dateTime, dateTime);
-    newReservation->numberOfTickets = numTickets;
-    newReservation->totalAmount = amount;
-    newReservation->priority = priority;
-    newReservation->status = TICKET_PENDING;
-    newReservation->requestTime = time(NULL);
-    newReservation->processTime = 0;
-    newReservation->confirmationTime = 0;
-    newReservation->estimatedWaitTime = calculateWaitTime(queue, priority);
-    newReservation->next = NULL;
+    unsigned char* out = journal->buffer + journal->bufferUsed;
+    writeLe32(out, (unsigned int)length);
+    writeLe32(out + 4, getJournalChecksum(payload, length));
+    memcpy(out + JOURNAL_RECORD_HEADER_BYTES, payload, length);
+    journal->bufferUsed += JOURNAL_RECORD_HEADER_BYTES + length;
+    journal->pendingRecords++;
+    journal->recordsWritten++;
     
-    // Priority-based insertion
-    if (isReservationQueueEmpty(queue)) {
-        queue->front = queue->rear = newReservation;
-    } else if (priority == PRIORITY_EMERGENCY || 
-               (priority == PRIORITY_VIP && queue->front->priority < PRIORITY_VIP)) {
-        // Insert at front for emergency or VIP (if front is not emergency)
-        newReservation->next = queue->front;
-        queue->front = newReservation;
-    } else {
-        // Find appropriate position based on priority
-        Reservation* current = queue->front;
-        Reservation* previous = NULL;
-        
-        while (current != NULL && current->priority >= priority) {
-            previous = current;
-            current = current->next;
-        }
-        
-        if (previous == NULL) {
-            // Insert at front
-            newReservation->next = queue->front;
-            queue->front = newReservation;
-        } else if (current == NULL) {
-            // Insert at rear
-            previous->next = newReservation;
-            queue->rear = newReservation;
-        } else {
-            // Insert in middle
-            previous->next = newReservation;
-            newReservation->next = current;
-        }
+    if (journal->pendingRecords >= journal->groupCommitRecords) {
+        commitJournal(journal);
+    }
+}
+
+// Function to write a string with a one-byte length (every field is shorter than 256)
+size_t writeJournalString(unsigned char* out, const char* text) {
+    size_t length = strlen(text);
+    out[0] = (unsigned char)length;
+    memcpy(out + 1, text, length);
+    return length + 1;
+}
+
+// Function to read a journal string into a buffer of bufferSize bytes;
+// returns the bytes consumed, or 0 if it runs past end or does not fit
+size_t readJournalString(const unsigned char* in, const unsigned char* end, char* buffer, size_t bufferSize) {
+    if (in >= end || in[0] >= bufferSize || in + 1 + in[0] > end) {
+        return 0;
+    }
+    memcpy(buffer, in + 1, in[0]);
+    buffer[in[0]] = '\0';
+    return (size_t)in[0] + 1;
+}
+
+// Function to journal a new counter together with its statistics
+void journalCounterAdded(ReservationJournal* journal, Counter* counter) {
+    if (journal == NULL) {
+        return;
     }
     
-    queue->size++;
-    queue->totalReservations++;
+    unsigned char payload[JOURNAL_MAX_PAYLOAD];
+    size_t used = 0;
+    payload[used++] = JOURNAL_COUNTER_ADDED;
+    payload[used++] = (unsigned char)counter->specialization;
+    payload[used++] = (unsigned char)counter->isActive;
+    writeLe32(payload + used, (unsigned int)counter->totalProcessed);
+    writeLe32(payload + used + 4, getFloatBits(counter->avgProcessingTime));
+    used += 8;
+    used += writeJournalString(payload + used, counter->counterName);
+    used += writeJournalString(payload + used, counter->operatorName);
+    appendJournalRecord(journal, payload, used);
+}
+
+// Function to journal a new reservation with everything needed to recreate it
+void journalReservationCreated(ReservationJournal* journal, Reservation* reservation) {
+    if (journal == NULL) {
+        return;
+    }
     
-    printf("🎫 Reservation created successfully!\n");
-    printf("   Reservation ID: %d\n", newReservation->reservationId);
-    printf("   Customer: %s\n", customerName);
-    printf("   Type: %s\n", getReservationTypeString(type));
-    printf("   Event: %s\n", eventName);
-    printf("   Tickets: %d\n", numTickets);
-    printf("   Amount: $%.2f\n", amount);
-    printf("   Priority: %s\n", getPriorityString(priority));
-    printf("   Estimated wait: %d minutes\n", newReservation->estimatedWaitTime);
+    unsigned char payload[JOURNAL_MAX_PAYLOAD];
+    size_t used = 0;
+    payload[used++] = JOURNAL_CREATED;
+    payload[used++] = (unsigned char)reservation->type;
+    payload[used++] = (unsigned char)reservation->priority;
+    writeLe32(payload + used, (unsigned int)reservation->reservationId);
+    writeLe32(payload + used + 4, (unsigned int)reservation->details->numberOfTickets);
+    writeLe32(payload + used + 8, getFloatBits(reservation->details->totalAmount));
+    writeLe64(payload + used + 12, (long long)reservation->requestTime);
+    used += 20;
+    used += writeJournalString(payload + used, reservation->details->customerName);
+    used += writeJournalString(payload + used, reservation->details->email);
+    used += writeJournalString(payload + used, reservation->details->phoneNumber);
+    used += writeJournalString(payload + used, reservation->details->eventName);
+    used += writeJournalString(payload + used, reservation->details->location);
+    used += writeJournalString(payload + used, reservation->details->dateTime);
+    appendJournalRecord(journal, payload, used);
+}
+
+// Function to journal a reservation being processed, confirmed or
+// cancelled at a counter (counter 0 with JOURNAL_CANCELLED: shed)
+void journalReservationEvent(ReservationJournal* journal, JournalRecordKind kind, int reservationId,
+                             int counterId, time_t when) {
+    if (journal == NULL) {
+        return;
+    }
     
-    return newReservation;
+    unsigned char payload[17];
+    payload[0] = (unsigned char)kind;
+    writeLe32(payload + 1, (unsigned int)reservationId);
+    writeLe32(payload + 5, (unsigned int)counterId);
+    writeLe64(payload + 9, (long long)when);
+    appendJournalRecord(journal, payload, sizeof(payload));
 }
 
-// Function to process next reservation
-Reservation* processNextReservation(ReservationQueue* queue, int counterId) {
-    if (isReservationQueueEmpty(queue)) {
-        printf("❌ No reservations in queue to process!\n");
-        return NULL;
+// Function to open a journal for appending after its first validBytes bytes
+// (cutting off a torn tail), or to start a new one when validBytes is 0.
+// The group size is clamped to 1..MAX_GROUP_COMMIT records.
+ReservationJournal* openReservationJournal(const char* path, long long validBytes, int groupCommitRecords) {
+    if (groupCommitRecords < 1) {
+        groupCommitRecords = 1;
+    } else if (groupCommitRecords > MAX_GROUP_COMMIT) {
+        groupCommitRecords = MAX_GROUP_COMMIT;
     }
     
-    if (counterId < 1 || counterId > queue->counterCount) {
-        printf("❌ Invalid counter ID!\n");
+    FILE* file = fopen(path, validBytes >= JOURNAL_HEADER_BYTES ? "r+b" : "wb");
+    if (file == NULL) {
+        printf("Error: Cannot open journal '%s'\n", path);
         return NULL;
     }
     
-    Counter* counter = &queue->counters[counterId - 1];
-    if (!counter->isActive) {
-        printf("❌ Counter %d is not active!\n", counterId);
+    int ok;
+    if (validBytes >= JOURNAL_HEADER_BYTES) {
+#ifdef _WIN32
+        ok = _chsize_s(_fileno(file), validBytes) == 0;
+#else
+        ok = ftruncate(fileno(file), (off_t)validBytes) == 0;
+#endif
+        ok = ok && fseek(file, 0, SEEK_END) == 0;
+    } else {
+        unsigned char header[JOURNAL_HEADER_BYTES];
+        writeLe32(header, JOURNAL_MAGIC);
+        writeLe32(header + 4, JOURNAL_VERSION);
+        ok = fwrite(header, 1, sizeof(header), file) == sizeof(header) && syncJournalFile(file);
+    }
+    if (!ok) {
+        printf("Error: Cannot prepare journal '%s' for appending\n", path);
+        fclose(file);
         return NULL;
     }
     
-    if (counter->currentReservation != NULL) {
-        printf("❌ Counter %d is currently processing reservation %d!\n", 
-               counterId, counter->currentReservation->reservationId);
+    ReservationJournal* journal = (ReservationJournal*)calloc(1, sizeof(ReservationJournal));
+    unsigned char* buffer = (unsigned char*)malloc((size_t)groupCommitRecords *
+                                                   (JOURNAL_RECORD_HEADER_BYTES + JOURNAL_MAX_PAYLOAD));
+    if (journal == NULL || buffer == NULL) {
+        printf("Error: Out of memory for the journal buffer\n");
+        free(journal);
+        free(buffer);
+        fclose(file);
         return NULL;
     }
+    journal->file = file;
+    snprintf(journal->path, sizeof(journal->path), "%s", path);
+    journal->groupCommitRecords = groupCommitRecords;
+    journal->buffer = buffer;
+    return journal;
+}
+
+// Function to commit any pending records and close the journal
+void closeReservationJournal(ReservationJournal* journal) {
+    if (journal == NULL) {
+        return;
+    }
     
-    // Find appropriate reservation for this counter
-    Reservation* reservation = NULL;
-    Reservation* previous = NULL;
-    Reservation* current = queue->front;
-    
-    // If counter has specialization, prioritize matching reservations
-    if (counter->specialization != 0) {
-        while (current != NULL) {
-            if (current->type == counter->specialization) {
-                reservation = current;
-                break;
+    commitJournal(journal);
+    fclose(journal->file);
+    free(journal->buffer);
+    free(journal);
+}
+
+// Function to get the home slot of a reservation ID (Fibonacci hashing:
+// the top bits of the product, since sequential IDs differ in the low bits)
+int getIndexSlot(ReservationIndex* index, int reservationId) {
+    int bits = __builtin_ctz((unsigned int)index->capacity);
+    return (int)(((unsigned long long)(unsigned int)reservationId * 11400714819323198485ULL) >> (64 - bits));
+}
+
+// Function to find the index entry of a reservation ID (NULL if unknown)
+IndexEntry* findIndexEntry(ReservationIndex* index, int reservationId) {
+    for (int slot = getIndexSlot(index, reservationId); index->entries[slot].reservationId != 0;
+         slot = (slot + 1) & (index->capacity - 1)) {
+        if (index->entries[slot].reservationId == reservationId) {
+            return &index->entries[slot];
+        }
+    }
+    return NULL;
+}
+
+// Function to add a new reservation to the index as queued, doubling the
+// table when it is half full
+void indexReservation(ReservationIndex* index, Reservation* reservation) {
+    if ((index->count + 1) * 2 > index->capacity) {
+        IndexEntry* oldEntries = index->entries;
+        int oldCapacity = index->capacity;
+        
+        index->capacity *= 2;
+        index->entries = (IndexEntry*)calloc(index->capacity, sizeof(IndexEntry));
+        for (int i = 0; i < oldCapacity; i++) {
+            if (oldEntries[i].reservationId != 0) {
+                int slot = getIndexSlot(index, oldEntries[i].reservationId);
+                while (index->entries[slot].reservationId != 0) {
+                    slot = (slot + 1) & (index->capacity - 1);
+                }
+                index->entries[slot] = oldEntries[i];
             }
-            previous = current;
-            current = current->next;
         }
+        free(oldEntries);
     }
     
-    // If no specialized reservation found, take the first available
-    if (reservation == NULL) {
-        reservation = queue->front;
-        previous = NULL;
+    int slot = getIndexSlot(index, reservation->reservationId);
+    while (index->entries[slot].reservationId != 0) {
+        slot = (slot + 1) & (index->capacity - 1);
+    }
+    IndexEntry* entry = &index->entries[slot];
+    entry->reservationId = reservation->reservationId;
+    entry->location = LOCATION_QUEUED;
+    entry->counterId = 0;
+    entry->status = reservation->status;
+    entry->reservation = reservation;
+    index->count++;
+}
+
+// Function to remove a reservation ID from the index. Backward-shift
+// deletion keeps every probe chain intact, so no tombstones are needed.
+void removeIndexEntry(ReservationIndex* index, int reservationId) {
+    IndexEntry* entry = findIndexEntry(index, reservationId);
+    if (entry == NULL) {
+        return;
     }
     
-    // Remove reservation from queue
-    if (previous == NULL) {
-        queue->front = reservation->next;
-        if (queue->front == NULL) {
-            queue->rear = NULL;
+    int hole = (int)(entry - index->entries);
+    int slot = hole;
+    for (;;) {
+        slot = (slot + 1) & (index->capacity - 1);
+        if (index->entries[slot].reservationId == 0) {
+            break;
         }
-    } else {
-        previous->next = reservation->next;
-        if (reservation == queue->rear) {
-            queue->rear = previous;
+        // Move the entry back if the hole lies between its home slot and its slot
+        int home = getIndexSlot(index, index->entries[slot].reservationId);
+        if (((slot - home) & (index->capacity - 1)) >= ((slot - hole) & (index->capacity - 1))) {
+            index->entries[hole] = index->entries[slot];
+            hole = slot;
         }
     }
+    index->entries[hole].reservationId = 0;
+    index->count--;
+}
+
+// Function to remember a finished reservation ID, dropping the oldest
+// finished entry from the index once the history is full
+void recordFinishedId(ReservationIndex* index, int reservationId) {
+    if (index->finishedCount == INDEX_FINISHED_HISTORY) {
+        removeIndexEntry(index, index->finishedIds[index->finishedHead]);
+        index->finishedIds[index->finishedHead] = reservationId;
+        index->finishedHead = (index->finishedHead + 1) % INDEX_FINISHED_HISTORY;
+    } else {
+        index->finishedIds[(index->finishedHead + index->finishedCount) % INDEX_FINISHED_HISTORY] = reservationId;
+        index->finishedCount++;
+    }
+}
+
+// Function to record a reservation's move to a counter or to finished
+void updateIndexLocation(ReservationIndex* index, Reservation* reservation,
+                         ReservationLocation location, int counterId) {
+    IndexEntry* entry = findIndexEntry(index, reservation->reservationId);
+    if (entry == NULL || entry->location == LOCATION_FINISHED) {
+        return;
+    }
     
-    queue->size--;
-    reservation->next = NULL;
-    reservation->processTime = time(NULL);
+    entry->location = location;
+    entry->counterId = counterId;
+    entry->status = reservation->status;
+    entry->reservation = location == LOCATION_FINISHED ? NULL : reservation;
+    if (location == LOCATION_FINISHED) {
+        recordFinishedId(index, reservation->reservationId);
+    }
+}
+
+// Function to get the service rate of a counter in reservations per minute
+double getCounterServiceRate(Counter* counter) {
+    float minutes = counter->avgProcessingTime > MIN_SERVICE_MINUTES ? counter->avgProcessingTime : MIN_SERVICE_MINUTES;
+    return counter->isActive ? 1.0 / minutes : 0.0;
+}
+
+// Function to estimate the wait for a reservation with position reservations ahead of it
+int estimateWaitTime(ReservationQueue* queue, int position, PriorityLevel priority) {
+    // Base wait time calculation
+    float baseTime = position * FLAT_MINUTES_PER_RESERVATION; // 4 minutes per reservation ahead
+    if (queue->useServiceRate && queue->serviceRate > 0) {
+        baseTime = (float)(position / queue->serviceRate);
+    }
     
-    // Assign to counter
-    counter->currentReservation = reservation;
+    switch (priority) {
+        case PRIORITY_EMERGENCY: return baseTime * 0.2f;
+        case PRIORITY_VIP: return baseTime * 0.5f;
+        case PRIORITY_PREMIUM: return baseTime * 0.7f;
+        default: return baseTime;
+    }
+}
+
+// Function to calculate estimated wait time in O(1) from the per-priority counts
+int calculateWaitTime(ReservationQueue* queue, PriorityLevel priority) {
+    int position = 0;
+    for (int level = priority; level <= PRIORITY_EMERGENCY; level++) {
+        position += queue->bandCount[level];
+    }
+    
+    return estimateWaitTime(queue, position, priority);
+}
+
+// Function to refresh the estimate of every waiting reservation in one pass,
+// after the counters changed. Everything ahead in the queue is served first.
+void refreshWaitTimes(ReservationQueue* queue) {
+    int position = 0;
+    for (Reservation* current = queue->front; current != NULL; current = current->next) {
+        current->estimatedWaitTime = estimateWaitTime(queue, position++, current->priority);
+    }
+}
+
+// Function to add service counter
+void addCounter(ReservationQueue* queue, char* counterName, char* operatorName, ReservationType specialization) {
+    if (queue->counterCount == queue->counterCapacity) {
+        queue->counterCapacity = queue->counterCapacity > 0 ? queue->counterCapacity * 2 : INITIAL_COUNTER_CAPACITY;
+        queue->counters = (Counter*)realloc(queue->counters, queue->counterCapacity * sizeof(Counter));
+    }
+    
+    Counter* counter = &queue->counters[queue->counterCount];
+    counter->counterId = queue->counterCount + 1;
+    strcpy(counter->counterName, counterName);
+    strcpy(counter->operatorName, operatorName);
+    counter->specialization = specialization;
+    counter->currentReservation = NULL;
+    counter->isActive = 1;
+    counter->totalProcessed = 0;
+    counter->avgProcessingTime = 3.0f; // Default 3 minutes
     
-    printf("🎟️  Processing reservation at Counter %d (%s)\n", counterId, counter->counterName);
-    printf("   Reservation ID: %d\n", reservation->reservationId);
-    printf("   Customer: %s\n", reservation->customerName);
-    printf("   Operator: %s\n", counter->operatorName);
+    queue->counterCount++;
+    queue->serviceRate += getCounterServiceRate(counter);
+    journalCounterAdded(queue->journal, counter);
+    if (queue->useServiceRate) {
+        refreshWaitTimes(queue);
+    }
+    logMessage("✅ Counter '%s' (ID: %d) with operator '%s' added successfully!\n", 
+           counterName, counter->counterId, operatorName);
     
-    return reservation;
+    if (specialization != 0) {
+        logMessage("   Specialization: %s reservations\n", getReservationTypeString(specialization));
+    } else {
+        logMessage("   Handles all types of reservations\n");
+    }
+}
+
+// Function to link a reservation into the queue after previous (NULL for the front)
+void linkReservationAfter(ReservationQueue* queue, Reservation* previous, Reservation* reservation) {
+    reservation->prev = previous;
+    reservation->next = previous != NULL ? previous->next : queue->front;
+    
+    if (reservation->next != NULL) {
+        reservation->next->prev = reservation;
+    } else {
+        queue->rear = reservation;
+    }
+    if (previous != NULL) {
+        previous->next = reservation;
+    } else {
+        queue->front = reservation;
+    }
+}
+
+// Function to insert a reservation into its priority band in O(1).
+// Emergencies go in front of everything (latest first); other priorities
+// join the back of their band, behind every reservation of equal or higher priority.
+// The type index follows the same rule, so both stay in queue order.
+void enqueueReservation(ReservationQueue* queue, Reservation* reservation) {
+    PriorityLevel priority = reservation->priority;
+    ReservationType type = reservation->type;
+    
+    queue->bandCount[priority]++;
+    
+    if (priority == PRIORITY_EMERGENCY) {
+        linkReservationAfter(queue, NULL, reservation);
+        queue->bandHead[priority] = reservation;
+        if (queue->bandTail[priority] == NULL) {
+            queue->bandTail[priority] = reservation;
+        }
+        
+        reservation->typePrev = NULL;
+        reservation->typeNext = queue->typeHead[type][priority];
+        if (reservation->typeNext != NULL) {
+            reservation->typeNext->typePrev = reservation;
+        } else {
+            queue->typeTail[type][priority] = reservation;
+        }
+        queue->typeHead[type][priority] = reservation;
+        return;
+    }
+    
+    // The band ends right after the nearest non-empty band of equal or higher priority
+    Reservation* previous = NULL;
+    for (int level = priority; level <= PRIORITY_EMERGENCY && previous == NULL; level++) {
+        previous = queue->bandTail[level];
+    }
+    
+    linkReservationAfter(queue, previous, reservation);
+    if (queue->bandHead[priority] == NULL) {
+        queue->bandHead[priority] = reservation;
+    }
+    queue->bandTail[priority] = reservation;
+    
+    reservation->typeNext = NULL;
+    reservation->typePrev = queue->typeTail[type][priority];
+    if (reservation->typePrev != NULL) {
+        reservation->typePrev->typeNext = reservation;
+    } else {
+        queue->typeHead[type][priority] = reservation;
+    }
+    queue->typeTail[type][priority] = reservation;
+}
+
+// Function to remove a reservation from the queue, its band and its type index in O(1)
+void unlinkReservation(ReservationQueue* queue, Reservation* reservation) {
+    PriorityLevel priority = reservation->priority;
+    ReservationType type = reservation->type;
+    
+    queue->bandCount[priority]--;
+    
+    if (queue->bandHead[priority] == reservation) {
+        queue->bandHead[priority] = reservation->next != NULL && reservation->next->priority == priority ?
+                                    reservation->next : NULL;
+    }
+    if (queue->bandTail[priority] == reservation) {
+        queue->bandTail[priority] = reservation->prev != NULL && reservation->prev->priority == priority ?
+                                    reservation->prev : NULL;
+    }
+    
+    if (reservation->prev != NULL) {
+        reservation->prev->next = reservation->next;
+    } else {
+        queue->front = reservation->next;
+    }
+    if (reservation->next != NULL) {
+        reservation->next->prev = reservation->prev;
+    } else {
+        queue->rear = reservation->prev;
+    }
+    
+    if (reservation->typePrev != NULL) {
+        reservation->typePrev->typeNext = reservation->typeNext;
+    } else {
+        queue->typeHead[type][priority] = reservation->typeNext;
+    }
+    if (reservation->typeNext != NULL) {
+        reservation->typeNext->typePrev = reservation->typePrev;
+    } else {
+        queue->typeTail[type][priority] = reservation->typePrev;
+    }
+    
+    reservation->next = NULL;
+    reservation->prev = NULL;
+    reservation->typeNext = NULL;
+    reservation->typePrev = NULL;
+}
+
+// Function to find the first waiting reservation of a type in queue order:
+// the head of its highest non-empty priority list (NULL if none)
+Reservation* findNextReservationOfType(ReservationQueue* queue, ReservationType type) {
+    for (int level = PRIORITY_EMERGENCY; level >= PRIORITY_NORMAL; level--) {
+        if (queue->typeHead[type][level] != NULL) {
+            return queue->typeHead[type][level];
+        }
+    }
+    return NULL;
+}
+
+// Function to cancel a waiting reservation to make room, without it ever
+// reaching a counter
+void shedReservation(ReservationQueue* queue, Reservation* victim) {
+    unlinkReservation(queue, victim);
+    queue->size--;
+    victim->status = TICKET_CANCELLED;
+    updateIndexLocation(&queue->index, victim, LOCATION_FINISHED, 0);
+    queue->totalShed++;
+    journalReservationEvent(queue->journal, JOURNAL_CANCELLED, victim->reservationId, 0, currentTime());
+    logMessage("⚠️  Queue full: shed %s reservation %d to make room\n",
+               getPriorityString(victim->priority), victim->reservationId);
+    freeReservation(queue, victim);
+}
+
+// Function to apply the overload policy when a reservation arrives at a full
+// queue. Returns 1 if room was made for it, 0 if it is turned away.
+int admitOverload(ReservationQueue* queue, PriorityLevel priority) {
+    if (queue->overloadPolicy == OVERLOAD_SHED_LOWEST) {
+        int lowest = PRIORITY_NORMAL;
+        while (lowest < (int)priority && queue->bandCount[lowest] == 0) {
+            lowest++;
+        }
+        
+        if (lowest < (int)priority) {
+            // The newest reservation of the lowest band is the one served last
+            shedReservation(queue, queue->bandTail[lowest]);
+            return 1;
+        }
+    } else if (queue->overloadPolicy == OVERLOAD_BLOCK) {
+        // Nothing else runs while an interactive caller waits, so no space could
+        // free up: the request is rejected rather than blocked. The simulator
+        // holds blocked arrivals in its lobby instead of calling this.
+        queue->totalRejected++;
+        logMessage("❌ Reservation queue is full! Blocking only applies to simulated arrivals, so the request is rejected.\n");
+        return 0;
+    }
+    
+    queue->totalRejected++;
+    logMessage("❌ Reservation queue is full! Cannot accept more reservations.\n");
+    return 0;
+}
+
+// Function to add reservation to queue (priority-based insertion)
+Reservation* addReservation(ReservationQueue* queue, char* customerName, char* email, char* phone,
+                           ReservationType type, char* eventName, char* location, char* dateTime,
+                           int numTickets, float amount, PriorityLevel priority) {
+    
+    if (isReservationQueueFull(queue) && !admitOverload(queue, priority)) {
+        return NULL;
+    }
+    
+    Reservation* newReservation = (Reservation*)malloc(sizeof(Reservation));
+    ReservationDetails* details = allocateReservationDetails(&queue->details);
+    newReservation->reservationId = queue->nextReservationId++;
+    strcpy(details->customerName, customerName);
+    strcpy(details->email, email);
+    strcpy(details->phoneNumber, phone);
+    newReservation->type = type;
+    details->eventName = internString(&queue->strings, eventName);
+    details->location = internString(&queue->strings, location);
+    strcpy(details->dateTime, dateTime);
+    details->numberOfTickets = numTickets;
+    details->totalAmount = amount;
+    newReservation->details = details;
+    newReservation->priority = priority;
+    newReservation->status = TICKET_PENDING;
+    newReservation->requestTime = currentTime();
+    newReservation->processTime = 0;
+    newReservation->confirmationTime = 0;
+    newReservation->estimatedWaitTime = calculateWaitTime(queue, priority);
+    newReservation->next = NULL;
+    newReservation->prev = NULL;
+    
+    // Priority-based insertion: emergencies go to the very front, every other
+    // priority joins the back of its band, in O(1)
+    enqueueReservation(queue, newReservation);
+    
+    indexReservation(&queue->index, newReservation);
+    queue->size++;
+    queue->totalReservations++;
+    journalReservationCreated(queue->journal, newReservation);
+    
+    logMessage("🎫 Reservation created successfully!\n");
+    logMessage("   Reservation ID: %d\n", newReservation->reservationId);
+    logMessage("   Customer: %s\n", customerName);
+    logMessage("   Type: %s\n", getReservationTypeString(type));
+    logMessage("   Event: %s\n", eventName);
+    logMessage("   Tickets: %d\n", numTickets);
+    logMessage("   Amount: $%.2f\n", amount);
+    logMessage("   Priority: %s\n", getPriorityString(priority));
+    logMessage("   Estimated wait: %d minutes\n", newReservation->estimatedWaitTime);
+    
+    return newReservation;
+}
+
+// Function to move a waiting reservation to a free counter
+void assignReservationToCounter(ReservationQueue* queue, Reservation* reservation, Counter* counter) {
+    unlinkReservation(queue, reservation);
+    queue->size--;
+    reservation->processTime = currentTime();
+    counter->currentReservation = reservation;
+    updateIndexLocation(&queue->index, reservation, LOCATION_AT_COUNTER, counter->counterId);
+    journalReservationEvent(queue->journal, JOURNAL_PROCESSED, reservation->reservationId, counter->counterId,
+                            reservation->processTime);
+}
+
+// Function to process next reservation
+Reservation* processNextReservation(ReservationQueue* queue, int counterId) {
+    if (isReservationQueueEmpty(queue)) {
+        logMessage("❌ No reservations in queue to process!\n");
+        return NULL;
+    }
+    
+    if (counterId < 1 || counterId > queue->counterCount) {
+        logMessage("❌ Invalid counter ID!\n");
+        return NULL;
+    }
+    
+    Counter* counter = &queue->counters[counterId - 1];
+    if (!counter->isActive) {
+        logMessage("❌ Counter %d is not active!\n", counterId);
+        return NULL;
+    }
+    
+    if (counter->currentReservation != NULL) {
+        logMessage("❌ Counter %d is currently processing reservation %d!\n", 
+               counterId, counter->currentReservation->reservationId);
+        return NULL;
+    }
+    
+    // Find appropriate reservation for this counter
+    Reservation* reservation = NULL;
+    
+    // If counter has specialization, prioritize matching reservations
+    if (counter->specialization != 0) {
+        reservation = findNextReservationOfType(queue, counter->specialization);
+    }
+    
+    // If no specialized reservation found, take the first available
+    if (reservation == NULL) {
+        reservation = queue->front;
+    }
+    
+    // Remove reservation from queue and assign it to the counter
+    assignReservationToCounter(queue, reservation, counter);
+    
+    logMessage("🎟️  Processing reservation at Counter %d (%s)\n", counterId, counter->counterName);
+    logMessage("   Reservation ID: %d\n", reservation->reservationId);
+    logMessage("   Customer: %s\n", reservation->details->customerName);
+    logMessage("   Operator: %s\n", counter->operatorName);
+    
+    return reservation;
+}
+
+// Function to confirm reservation
+void confirmReservation(ReservationQueue* queue, int counterId) {
+    if (counterId < 1 || counterId > queue->counterCount) {
+        logMessage("❌ Invalid counter ID!\n");
+        return;
+    }
+    
+    Counter* counter = &queue->counters[counterId - 1];
+    
+    if (counter->currentReservation == NULL) {
+        logMessage("❌ No reservation being processed at counter %d!\n", counterId);
+        return;
+    }
+    
+    Reservation* reservation = counter->currentReservation;
+    ReservationDetails* details = reservation->details;
+    reservation->status = TICKET_CONFIRMED;
+    reservation->confirmationTime = currentTime();
+    
+    // Update statistics
+    queue->totalConfirmed++;
+    queue->totalRevenue += details->totalAmount;
+    counter->totalProcessed++;
+    
+    // Update average processing time
+    float processingTime = difftime(reservation->confirmationTime, reservation->processTime) / 60.0f;
+    queue->serviceRate -= getCounterServiceRate(counter);
+    counter->avgProcessingTime = ((counter->avgProcessingTime * (counter->totalProcessed - 1)) + processingTime) / counter->totalProcessed;
+    queue->serviceRate += getCounterServiceRate(counter);
+    if (queue->useServiceRate) {
+        refreshWaitTimes(queue);
+    }
+    journalReservationEvent(queue->journal, JOURNAL_CONFIRMED, reservation->reservationId, counterId,
+                            reservation->confirmationTime);
+    
+    logMessage("✅ Reservation %d confirmed successfully!\n", reservation->reservationId);
+    logMessage("   Customer: %s\n", details->customerName);
+    logMessage("   Total Amount: $%.2f\n", details->totalAmount);
+    logMessage("   Processing Time: %.1f minutes\n", processingTime);
+    logMessage("   Total Wait Time: %.1f minutes\n", 
+           difftime(reservation->confirmationTime, reservation->requestTime) / 60.0f);
+    
+    // Generate confirmation details
+    logMessage("\n--- TICKET CONFIRMATION ---\n");
+    logMessage("Confirmation Number: TKT%d\n", reservation->reservationId);
+    logMessage("Customer: %s\n", details->customerName);
+    logMessage("Email: %s\n", details->email);
+    logMessage("Phone: %s\n", details->phoneNumber);
+    logMessage("Event: %s\n", details->eventName);
+    logMessage("Location: %s\n", details->location);
+    logMessage("Date/Time: %s\n", details->dateTime);
+    logMessage("Number of Tickets: %d\n", details->numberOfTickets);
+    logMessage("Total Amount: $%.2f\n", details->totalAmount);
+    logMessage("Status: CONFIRMED\n");
+    logMessage("---------------------------\n");
+    
+    // Free the reservation and reset counter
+    updateIndexLocation(&queue->index, reservation, LOCATION_FINISHED, 0);
+    freeReservation(queue, reservation);
+    counter->currentReservation = NULL;
+    
+    logMessage("Counter %d is now available for next customer\n", counterId);
+}
+
+// Function to cancel reservation
+void cancelReservation(ReservationQueue* queue, int counterId) {
+    if (counterId < 1 || counterId > queue->counterCount) {
+        logMessage("❌ Invalid counter ID!\n");
+        return;
+    }
+    
+    Counter* counter = &queue->counters[counterId - 1];
+    
+    if (counter->currentReservation == NULL) {
+        logMessage("❌ No reservation being processed at counter %d!\n", counterId);
+        return;
+    }
+    
+    Reservation* reservation = counter->currentReservation;
+    reservation->status = TICKET_CANCELLED;
+    
+    queue->totalCancelled++;
+    counter->totalProcessed++;
+    journalReservationEvent(queue->journal, JOURNAL_CANCELLED, reservation->reservationId, counterId, currentTime());
+    
+    logMessage("❌ Reservation %d cancelled\n", reservation->reservationId);
+    logMessage("   Customer: %s\n", reservation->details->customerName);
+    logMessage("   Reason: Customer request / Payment issue\n");
+    
+    // Free the reservation and reset counter
+    updateIndexLocation(&queue->index, reservation, LOCATION_FINISHED, 0);
+    freeReservation(queue, reservation);
+    counter->currentReservation = NULL;
+    
+    logMessage("Counter %d is now available for next customer\n", counterId);
+}
+
+// Function to display queue status
+void displayQueueStatus(ReservationQueue* queue) {
+    printf("\n=== RESERVATION QUEUE STATUS ===\n");
+    printf("Reservations in queue: %d\n", queue->size);
+    printf("Next reservation ID: %d\n", queue->nextReservationId);
+    printf("Total reservations: %d\n", queue->totalReservations);
+    printf("Total confirmed: %d\n", queue->totalConfirmed);
+    printf("Total cancelled: %d\n", queue->totalCancelled);
+    printf("Total revenue: $%.2f\n", queue->totalRevenue);
+    printf("Success rate: %.1f%%\n", 
+           queue->totalReservations > 0 ? (float)queue->totalConfirmed / queue->totalReservations * 100 : 0);
+    printf("Waiting by priority: Emergency %d, VIP %d, Premium %d, Normal %d\n",
+           queue->bandCount[PRIORITY_EMERGENCY], queue->bandCount[PRIORITY_VIP],
+           queue->bandCount[PRIORITY_PREMIUM], queue->bandCount[PRIORITY_NORMAL]);
+    if (queue->capacity > 0) {
+        printf("Capacity: %d, when full: %s\n", queue->capacity, getOverloadPolicyString(queue->overloadPolicy));
+    } else {
+        printf("Capacity: unbounded\n");
+    }
+    printf("Overload: %d rejected, %d shed, %d blocked (%d timed out, %.1f minutes blocked)\n",
+           queue->totalRejected, queue->totalShed, queue->totalBlocked, queue->totalBlockTimeouts,
+           queue->totalBlockedMinutes);
+    if (queue->useServiceRate) {
+        printf("Wait model: counter service rate (%.2f reservations/minute)\n", queue->serviceRate);
+    } else {
+        printf("Wait model: flat %d minutes per reservation ahead\n", FLAT_MINUTES_PER_RESERVATION);
+    }
+    
+    if (isReservationQueueEmpty(queue)) {
+        printf("\nNo reservations waiting in queue\n");
+    } else {
+        printf("\nWaiting reservations:\n");
+        printf("%-6s %-20s %-8s %-25s %-8s %-10s %-8s\n", 
+               "ID", "Customer", "Type", "Event", "Tickets", "Amount", "Priority");
+        printf("-------------------------------------------------------------------------------------\n");
+        
+        Reservation* current = queue->front;
+        while (current != NULL) {
+            printf("%-6d %-20s %-8s %-25s %-8d $%-9.2f %-8s\n",
+                   current->reservationId,
+                   current->details->customerName,
+                   getReservationTypeString(current->type),
+                   current->details->eventName,
+                   current->details->numberOfTickets,
+                   current->details->totalAmount,
+                   getPriorityString(current->priority));
+            current = current->next;
+        }
+    }
+    printf("================================\n\n");
+}
+
+// Function to display counter status
+void displayCounterStatus(ReservationQueue* queue) {
+    if (queue->counterCount == 0) {
+        printf("No service counters configured!\n");
+        return;
+    }
+    
+    printf("\n=== COUNTER STATUS ===\n");
+    printf("%-8s %-20s %-15s %-10s %-15s %-12s %-10s\n",
+           "Counter", "Name", "Operator", "Status", "Specialization", "Avg Time", "Processed");
+    printf("------------------------------------------------------------------------------------------------\n");
+    
+    for (int i = 0; i < queue->counterCount; i++) {
+        Counter* counter = &queue->counters[i];
+        char status[20], specialization[20];
+        
+        if (!counter->isActive) {
+            strcpy(status, "Inactive");
+        } else if (counter->currentReservation == NULL) {
+            strcpy(status, "Available");
+        } else {
+            sprintf(status, "Busy (ID:%d)", counter->currentReservation->reservationId);
+        }
+        
+        if (counter->specialization == 0) {
+            strcpy(specialization, "All Types");
+        } else {
+            strcpy(specialization, getReservationTypeString(counter->specialization));
+        }
+        
+        printf("%-8d %-20s %-15s %-10s %-15s %-12.1f %-10d\n",
+               counter->counterId,
+               counter->counterName,
+               counter->operatorName,
+               status,
+               specialization,
+               counter->avgProcessingTime,
+               counter->totalProcessed);
+    }
+    printf("=====================\n\n");
+}
+
+// Function to search reservation by ID through the index in O(1)
+void searchReservation(ReservationQueue* queue, int reservationId) {
+    IndexEntry* entry = findIndexEntry(&queue->index, reservationId);
+    if (entry == NULL) {
+        printf("❌ Reservation ID %d not found!\n", reservationId);
+        return;
+    }
+    
+    if (entry->location == LOCATION_QUEUED) {
+        Reservation* current = entry->reservation;
+        printf("\n=== RESERVATION FOUND (In Queue) ===\n");
+        printf("Reservation ID: %d\n", current->reservationId);
+        printf("Customer: %s\n", current->details->customerName);
+        printf("Email: %s\n", current->details->email);
+        printf("Phone: %s\n", current->details->phoneNumber);
+        printf("Type: %s\n", getReservationTypeString(current->type));
+        printf("Event: %s\n", current->details->eventName);
+        printf("Location: %s\n", current->details->location);
+        printf("Date/Time: %s\n", current->details->dateTime);
+        printf("Tickets: %d\n", current->details->numberOfTickets);
+        printf("Amount: $%.2f\n", current->details->totalAmount);
+        printf("Priority: %s\n", getPriorityString(current->priority));
+        printf("Status: %s\n", getTicketStatusString(current->status));
+        printf("Wait Time: %d minutes\n", current->estimatedWaitTime);
+        printf("===================================\n");
+    } else if (entry->location == LOCATION_AT_COUNTER) {
+        Reservation* res = entry->reservation;
+        Counter* counter = &queue->counters[entry->counterId - 1];
+        printf("\n=== RESERVATION FOUND (Being Processed) ===\n");
+        printf("Reservation ID: %d\n", res->reservationId);
+        printf("Customer: %s\n", res->details->customerName);
+        printf("Current Status: Being processed at Counter %d\n", counter->counterId);
+        printf("Operator: %s\n", counter->operatorName);
+        printf("Processing Time: %.1f minutes\n", 
+               difftime(currentTime(), res->processTime) / 60.0f);
+        printf("==========================================\n");
+    } else {
+        printf("\n=== RESERVATION FOUND (Finished) ===\n");
+        printf("Reservation ID: %d\n", entry->reservationId);
+        printf("Status: %s\n", getTicketStatusString(entry->status));
+        printf("===================================\n");
+    }
+}
+
+// Function to setup sample data
+void setupSampleReservationData(ReservationQueue* queue) {
+    printf("Setting up sample reservation data...\n");
+    
+    // Add service counters
+    addCounter(queue, "Movie Tickets", "Alice Johnson", RESERVATION_MOVIE);
+    addCounter(queue, "Flight Booking", "Bob Smith", RESERVATION_FLIGHT);
+    addCounter(queue, "Train Reservations", "Carol Davis", RESERVATION_TRAIN);
+    addCounter(queue, "Event Tickets", "David Wilson", RESERVATION_EVENT);
+    addCounter(queue, "General Service", "Emma Brown", 0); // All types
+    
+    // Add sample reservations
+    addReservation(queue, "John Doe", "john.doe@email.com", "555-0101",
+                  RESERVATION_MOVIE, "Avengers: Endgame", "Cinema City Mall", 
+                  "2024-01-15 19:30", 2, 24.50f, PRIORITY_NORMAL);
+    
+    addReservation(queue, "Sarah Johnson", "sarah.j@email.com", "555-0102",
+                  RESERVATION_FLIGHT, "Flight AA123", "New York to London", 
+                  "2024-01-20 14:30", 1, 750.00f, PRIORITY_PREMIUM);
+    
+    addReservation(queue, "Mike Chen", "mike.chen@email.com", "555-0103",
+                  RESERVATION_TRAIN, "Express Train 456", "Boston to Washington", 
+                  "2024-01-18 08:15", 2, 180.00f, PRIORITY_NORMAL);
+    
+    addReservation(queue, "Lisa Williams", "lisa.w@email.com", "555-0104",
+                  RESERVATION_EVENT, "Concert: Rock Legends", "Madison Square Garden", 
+                  "2024-01-25 20:00", 4, 320.00f, PRIORITY_VIP);
+    
+    addReservation(queue, "Emergency Travel", "urgent@email.com", "555-0105",
+                  RESERVATION_FLIGHT, "Emergency Flight", "Medical Emergency", 
+                  "2024-01-16 ASAP", 1, 1200.00f, PRIORITY_EMERGENCY);
+    
+    addReservation(queue, "Robert Garcia", "rob.garcia@email.com", "555-0106",
+                  RESERVATION_HOTEL, "Grand Hotel Suite", "Downtown Manhattan", 
+                  "2024-01-22 Check-in", 1, 450.00f, PRIORITY_NORMAL);
+    
+    printf("Sample reservation data setup complete!\n");
+}
+
+// Function to free the reservation queue
+void freeReservationQueue(ReservationQueue* queue) {
+    while (!isReservationQueueEmpty(queue)) {
+        Reservation* reservation = queue->front;
+        queue->front = queue->front->next;
+        freeReservation(queue, reservation);
+    }
+    
+    // Free any reservations still being processed
+    for (int i = 0; i < queue->counterCount; i++) {
+        if (queue->counters[i].currentReservation != NULL) {
+            freeReservation(queue, queue->counters[i].currentReservation);
+        }
+    }
+    
+    closeReservationJournal(queue->journal);
+    for (int i = 0; i < queue->details.chunkCount; i++) {
+        free(queue->details.chunks[i]);
+    }
+    free(queue->details.chunks);
+    for (int i = 0; i < queue->strings.capacity; i++) {
+        free(queue->strings.slots[i]);
+    }
+    free(queue->strings.slots);
+    free(queue->index.entries);
+    free(queue->index.finishedIds);
+    free(queue->counters);
+    free(queue);
+}
+
+// Function to get the next value from a xorshift generator (reproducible simulations)
+unsigned int nextRandom(unsigned int* state) {
+    unsigned int x = *state;
+    x ^= x << 13;
+    x ^= x >> 17;
+    x ^= x << 5;
+    *state = x;
+    return x;
+}
+
+// Function to draw a uniform random number in [0, 1)
+double nextUniform(unsigned int* state) {
+    return (nextRandom(state) >> 8) / 16777216.0;
+}
+
+// Function to draw an exponentially distributed value with the given mean
+double nextExponential(unsigned int* state, double mean) {
+    return -log(1.0 - nextUniform(state)) * mean;
+}
+
+// Function to pick a priority from the simulated mix
+PriorityLevel pickSimulatedPriority(unsigned int* state) {
+    unsigned int roll = nextRandom(state) % 100;
+    if (roll < SIM_EMERGENCY_PERCENT) {
+        return PRIORITY_EMERGENCY;
+    }
+    if (roll < SIM_EMERGENCY_PERCENT + SIM_VIP_PERCENT) {
+        return PRIORITY_VIP;
+    }
+    if (roll < SIM_EMERGENCY_PERCENT + SIM_VIP_PERCENT + SIM_PREMIUM_PERCENT) {
+        return PRIORITY_PREMIUM;
+    }
+    return PRIORITY_NORMAL;
+}
+
+// Virtual clock read by currentTime() while a simulation runs
+static double simulatedSeconds = 0.0;
+
+// Function to read the simulator's virtual clock
+time_t readSimulatedClock() {
+    return (time_t)simulatedSeconds;
+}
+
+// Function to load a trace of arrivals: one "minute type priority" line per
+// reservation, in time order. Returns the number of arrivals (-1 on error).
+int loadArrivalTrace(const char* path, SimArrival** arrivals) {
+    FILE* file = fopen(path, "r");
+    if (file == NULL) {
+        printf("❌ Cannot open arrival trace '%s'!\n", path);
+        return -1;
+    }
+    
+    int count = 0, capacity = 1024, type, priority;
+    double minute, lastMinute = 0.0;
+    *arrivals = (SimArrival*)malloc(capacity * sizeof(SimArrival));
+    
+    while (fscanf(file, "%lf %d %d", &minute, &type, &priority) == 3) {
+        if (type < RESERVATION_MOVIE || type > RESERVATION_HOTEL ||
+            priority < PRIORITY_NORMAL || priority > PRIORITY_EMERGENCY || minute < lastMinute) {
+            printf("❌ Invalid arrival on line %d of '%s'!\n", count + 1, path);
+            free(*arrivals);
+            *arrivals = NULL;
+            fclose(file);
+            return -1;
+        }
+        if (count == capacity) {
+            capacity *= 2;
+            *arrivals = (SimArrival*)realloc(*arrivals, capacity * sizeof(SimArrival));
+        }
+        (*arrivals)[count].seconds = minute * 60.0;
+        (*arrivals)[count].type = (ReservationType)type;
+        (*arrivals)[count].priority = (PriorityLevel)priority;
+        lastMinute = minute;
+        count++;
+    }
+    
+    fclose(file);
+    return count;
+}
+
+// Function to push a counter's completion time onto the event heap
+void pushSimEvent(SimEvent* heap, int* count, SimEvent event) {
+    int child = (*count)++;
+    while (child > 0 && heap[(child - 1) / 2].seconds > event.seconds) {
+        heap[child] = heap[(child - 1) / 2];
+        child = (child - 1) / 2;
+    }
+    heap[child] = event;
+}
+
+// Function to pop the earliest completion from the event heap
+SimEvent popSimEvent(SimEvent* heap, int* count) {
+    SimEvent top = heap[0];
+    SimEvent last = heap[--(*count)];
+    int parent = 0;
+    
+    while (2 * parent + 1 < *count) {
+        int child = 2 * parent + 1;
+        if (child + 1 < *count && heap[child + 1].seconds < heap[child].seconds) {
+            child++;
+        }
+        if (heap[child].seconds >= last.seconds) {
+            break;
+        }
+        heap[parent] = heap[child];
+        parent = child;
+    }
+    heap[parent] = last;
+    return top;
+}
+
+// Function to compare wait samples for qsort
+int compareWaits(const void* a, const void* b) {
+    int left = *(const int*)a;
+    int right = *(const int*)b;
+    return (left > right) - (left < right);
+}
+
+// Function to get a percentile (0-100) of sorted wait samples
+int getWaitPercentile(int* waits, int count, double percentile) {
+    if (count == 0) {
+        return 0;
+    }
+    int rank = (int)(count * percentile / 100.0);
+    return waits[rank < count ? rank : count - 1];
+}
+
+// Function to start serving on every idle counter while reservations wait.
+// Each taken reservation's wait is recorded and its completion scheduled.
+void dispatchIdleCounters(ReservationQueue* queue, SimulationConfig* config, SimEvent* heap, int* heapCount,
+                          SimulationResult* result, unsigned int* rngState) {
+    for (int i = 0; i < queue->counterCount && !isReservationQueueEmpty(queue); i++) {
+        Counter* counter = &queue->counters[i];
+        if (!counter->isActive || counter->currentReservation != NULL) {
+            continue;
+        }
+        
+        Reservation* reservation = processNextReservation(queue, counter->counterId);
+        int priority = reservation->priority;
+        if (result->waitCounts[priority] == result->waitCapacity[priority]) {
+            result->waitCapacity[priority] = result->waitCapacity[priority] * 2 + 1024;
+            result->waits[priority] = (int*)realloc(result->waits[priority],
+                                                   result->waitCapacity[priority] * sizeof(int));
+        }
+        result->waits[priority][result->waitCounts[priority]++] =
+            (int)(reservation->processTime - reservation->requestTime);
+        
+        SimEvent event;
+        event.seconds = simulatedSeconds + nextExponential(rngState, config->meanServiceMinutes * 60.0);
+        event.counterIndex = i;
+        result->busySeconds[i] += event.seconds - simulatedSeconds;
+        pushSimEvent(heap, heapCount, event);
+    }
+}
+
+// Function to run a discrete-event simulation on a fresh queue with the same
+// counters as layout. Arrivals are Poisson (or read from arrivals when
+// arrivalCount >= 0); service times are exponential. Time advances from event
+// to event on a virtual clock, and the real queue functions run quietly.
+SimulationResult runReservationSimulation(ReservationQueue* layout, SimulationConfig* config,
+                                          SimArrival* arrivals, int arrivalCount) {
+    SimulationResult result;
+    memset(&result, 0, sizeof(result));
+    
+    ReservationQueue* queue = createReservationQueue();
+    queue->capacity = layout->capacity;
+    queue->overloadPolicy = layout->overloadPolicy;
+    queue->blockTimeoutMinutes = layout->blockTimeoutMinutes;
+    quietMode = 1;
+    for (int i = 0; i < layout->counterCount; i++) {
+        addCounter(queue, layout->counters[i].counterName, layout->counters[i].operatorName,
+                   layout->counters[i].specialization);
+    }
+    
+    result.counterCount = queue->counterCount;
+    result.busySeconds = (double*)calloc(queue->counterCount, sizeof(double));
+    SimEvent* heap = (SimEvent*)malloc((queue->counterCount + 1) * sizeof(SimEvent));
+    int heapCount = 0;
+    unsigned int rngState = config->seed != 0 ? config->seed : 1;
+    double durationSeconds = config->durationMinutes * 60.0;
+    double nextArrival, lastEvent = 0.0, queueArea = 0.0;
+    int arrivalIndex = 0;
+    SimArrival* lobby = NULL;    // Arrivals blocked by a full queue, oldest first
+    int lobbyHead = 0, lobbyCount = 0, lobbyCapacity = 0;
+    
+    if (arrivalCount >= 0) {
+        nextArrival = arrivalCount > 0 ? arrivals[0].seconds : INFINITY;
+    } else {
+        nextArrival = nextExponential(&rngState, 60.0 / config->arrivalsPerMinute);
+    }
+    
+    simulatedSeconds = 0.0;
+    reservationClock = readSimulatedClock;
+    double wallBegin = (double)clock();
+    
+    while (nextArrival < INFINITY || heapCount > 0) {
+        int isArrival = heapCount == 0 || nextArrival <= heap[0].seconds;
+        double eventTime = isArrival ? nextArrival : heap[0].seconds;
+        
+        queueArea += queue->size * (eventTime - lastEvent);
+        lastEvent = eventTime;
+        simulatedSeconds = eventTime;
+        result.events++;
+        
+        if (isArrival) {
+            ReservationType type;
+            PriorityLevel priority;
+            if (arrivalCount >= 0) {
+                type = arrivals[arrivalIndex].type;
+                priority = arrivals[arrivalIndex].priority;
+                arrivalIndex++;
+                nextArrival = arrivalIndex < arrivalCount ? arrivals[arrivalIndex].seconds : INFINITY;
+            } else {
+                type = (ReservationType)(RESERVATION_MOVIE + nextRandom(&rngState) % 5);
+                priority = pickSimulatedPriority(&rngState);
+                nextArrival += nextExponential(&rngState, 60.0 / config->arrivalsPerMinute);
+                if (nextArrival >= durationSeconds) {
+                    nextArrival = INFINITY;
+                }
+            }
+            
+            result.arrivals++;
+            if (queue->overloadPolicy == OVERLOAD_BLOCK && isReservationQueueFull(queue)) {
+                if (lobbyCount == lobbyCapacity) {
+                    lobbyCapacity = lobbyCapacity * 2 + 1024;
+                    lobby = (SimArrival*)realloc(lobby, lobbyCapacity * sizeof(SimArrival));
+                }
+                lobby[lobbyCount].seconds = eventTime;
+                lobby[lobbyCount].type = type;
+                lobby[lobbyCount].priority = priority;
+                lobbyCount++;
+                queue->totalBlocked++;
+            } else {
+                addReservation(queue, "Simulated Customer", "sim@email.com", "555-0000", type,
+                               "Simulated Event", "Simulated Venue", "ASAP", 1, 25.0f, priority);
+            }
+            if (queue->size > result.maxQueueLength) {
+                result.maxQueueLength = queue->size;
+            }
+        } else {
+            SimEvent event = popSimEvent(heap, &heapCount);
+            confirmReservation(queue, queue->counters[event.counterIndex].counterId);
+            result.served++;
+        }
+        
+        dispatchIdleCounters(queue, config, heap, &heapCount, &result, &rngState);
+        
+        // Blocked arrivals take freed places in order; those past their timeout give up
+        if (lobbyHead < lobbyCount && !isReservationQueueFull(queue)) {
+            while (lobbyHead < lobbyCount && !isReservationQueueFull(queue)) {
+                SimArrival* waiting = &lobby[lobbyHead++];
+                double blockedSeconds = eventTime - waiting->seconds;
+                if (blockedSeconds > queue->blockTimeoutMinutes * 60.0) {
+                    queue->totalBlockTimeouts++;
+                    queue->totalBlockedMinutes += queue->blockTimeoutMinutes;
+                    continue;
+                }
+                queue->totalBlockedMinutes += blockedSeconds / 60.0;
+                addReservation(queue, "Simulated Customer", "sim@email.com", "555-0000", waiting->type,
+                               "Simulated Event", "Simulated Venue", "ASAP", 1, 25.0f, waiting->priority);
+            }
+            dispatchIdleCounters(queue, config, heap, &heapCount, &result, &rngState);
+        }
+    }
+    
+    result.wallSeconds = ((double)clock() - wallBegin) / CLOCKS_PER_SEC;
+    result.simulatedMinutes = lastEvent / 60.0;
+    result.avgQueueLength = lastEvent > 0 ? queueArea / lastEvent : 0.0;
+    result.rejected = queue->totalRejected;
+    result.shed = queue->totalShed;
+    result.blocked = queue->totalBlocked;
+    result.blockTimeouts = queue->totalBlockTimeouts;
+    result.blockedMinutes = queue->totalBlockedMinutes;
+    reservationClock = NULL;
+    quietMode = 0;
+    
+    for (int level = PRIORITY_NORMAL; level <= PRIORITY_EMERGENCY; level++) {
+        qsort(result.waits[level], result.waitCounts[level], sizeof(int), compareWaits);
+    }
+    
+    free(lobby);
+    free(heap);
+    freeReservationQueue(queue);
+    return result;
+}
+
+// Function to print a simulation report: queue length, wait percentiles per
+// priority and utilization per counter
+void displaySimulationResult(ReservationQueue* layout, SimulationResult* result) {
+    printf("\n=== RESERVATION LOAD SIMULATION ===\n");
+    printf("Simulated time: %.1f minutes (%.2f s of CPU, %ld events)\n",
+           result->simulatedMinutes, result->wallSeconds, result->events);
+    printf("Arrivals: %ld, served: %ld\n", result->arrivals, result->served);
+    if (layout->capacity > 0) {
+        printf("Capacity %d (%s): %ld rejected, %ld shed, %ld blocked (%ld timed out, average block %.1f minutes)\n",
+               layout->capacity, getOverloadPolicyString(layout->overloadPolicy), result->rejected, result->shed,
+               result->blocked, result->blockTimeouts,
+               result->blocked > 0 ? result->blockedMinutes / result->blocked : 0.0);
+    }
+    printf("Queue length: average %.1f, maximum %d\n", result->avgQueueLength, result->maxQueueLength);
+    
+    printf("\n%-10s %10s %10s %10s %10s %10s\n", "Priority", "Served", "p50 min", "p90 min", "p99 min", "Max min");
+    for (int level = PRIORITY_EMERGENCY; level >= PRIORITY_NORMAL; level--) {
+        int* waits = result->waits[level];
+        int count = result->waitCounts[level];
+        printf("%-10s %10d %10.1f %10.1f %10.1f %10.1f\n", getPriorityString((PriorityLevel)level), count,
+               getWaitPercentile(waits, count, 50) / 60.0, getWaitPercentile(waits, count, 90) / 60.0,
+               getWaitPercentile(waits, count, 99) / 60.0, count > 0 ? waits[count - 1] / 60.0 : 0.0);
+    }
+    
+    printf("\n%-8s %-20s %-15s %12s\n", "Counter", "Name", "Specialization", "Utilization");
+    for (int i = 0; i < result->counterCount; i++) {
+        Counter* counter = &layout->counters[i];
+        printf("%-8d %-20s %-15s %11.1f%%\n", counter->counterId, counter->counterName,
+               counter->specialization == 0 ? "All Types" : getReservationTypeString(counter->specialization),
+               result->simulatedMinutes > 0 ? result->busySeconds[i] / (result->simulatedMinutes * 60.0) * 100 : 0.0);
+    }
+    printf("===================================\n");
+}
+
+// Function to free the samples of a simulation result
+void freeSimulationResult(SimulationResult* result) {
+    for (int level = 0; level < PRIORITY_LEVELS; level++) {
+        free(result->waits[level]);
+    }
+    free(result->busySeconds);
+}
+
+// Time of the journal record being replayed, read by currentTime()
+static time_t replayTime = 0;
+
+// Function to read the replay clock, so rebuilt reservations keep their journaled times
+time_t readReplayClock() {
+    return replayTime;
+}
+
+// Function to journal the queue totals and next ID (closes a snapshot)
+void journalTotals(ReservationJournal* journal, ReservationQueue* queue) {
+    unsigned char payload[25];
+    payload[0] = JOURNAL_TOTALS;
+    writeLe32(payload + 1, (unsigned int)queue->nextReservationId);
+    writeLe32(payload + 5, (unsigned int)queue->totalReservations);
+    writeLe32(payload + 9, (unsigned int)queue->totalConfirmed);
+    writeLe32(payload + 13, (unsigned int)queue->totalCancelled);
+    writeLe32(payload + 17, (unsigned int)queue->totalShed);
+    writeLe32(payload + 21, getFloatBits(queue->totalRevenue));
+    appendJournalRecord(journal, payload, sizeof(payload));
+}
+
+// Function to apply one journal record to a queue being rebuilt, through
+// the same functions that made the change. Returns 0 if the record does
+// not fit the state rebuilt so far (it is then skipped).
+int replayJournalRecord(ReservationQueue* queue, const unsigned char* payload, size_t length) {
+    const unsigned char* end = payload + length;
+    
+    switch (payload[0]) {
+        case JOURNAL_COUNTER_ADDED: {
+            char counterName[MAX_NAME_LENGTH], operatorName[MAX_NAME_LENGTH];
+            size_t used = 11, consumed;
+            if (length < used || payload[1] >= RESERVATION_TYPES ||
+                (consumed = readJournalString(payload + used, end, counterName, sizeof(counterName))) == 0 ||
+                readJournalString(payload + used + consumed, end, operatorName, sizeof(operatorName)) == 0) {
+                return 0;
+            }
+            
+            addCounter(queue, counterName, operatorName, (ReservationType)payload[1]);
+            Counter* counter = &queue->counters[queue->counterCount - 1];
+            queue->serviceRate -= getCounterServiceRate(counter);
+            counter->isActive = payload[2];
+            counter->totalProcessed = (int)readLe32(payload + 3);
+            counter->avgProcessingTime = getFloatFromBits(readLe32(payload + 7));
+            queue->serviceRate += getCounterServiceRate(counter);
+            return 1;
+        }
+        
+        case JOURNAL_CREATED: {
+            char customerName[MAX_NAME_LENGTH], email[MAX_NAME_LENGTH], phone[20];
+            char eventName[MAX_EVENT_NAME], location[MAX_LOCATION_NAME], dateTime[30];
+            char* fields[] = {customerName, email, phone, eventName, location, dateTime};
+            size_t sizes[] = {sizeof(customerName), sizeof(email), sizeof(phone),
+                              sizeof(eventName), sizeof(location), sizeof(dateTime)};
+            size_t used = 23;
+            if (length < used || payload[1] < RESERVATION_MOVIE || payload[1] > RESERVATION_HOTEL ||
+                payload[2] < PRIORITY_NORMAL || payload[2] > PRIORITY_EMERGENCY ||
+                findIndexEntry(&queue->index, (int)readLe32(payload + 3)) != NULL) {
+                return 0;
+            }
+            for (int i = 0; i < 6; i++) {
+                size_t consumed = readJournalString(payload + used, end, fields[i], sizes[i]);
+                if (consumed == 0) {
+                    return 0;
+                }
+                used += consumed;
+            }
+            
+            queue->nextReservationId = (int)readLe32(payload + 3);
+            replayTime = (time_t)readLe64(payload + 15);
+            return addReservation(queue, customerName, email, phone, (ReservationType)payload[1],
+                                  eventName, location, dateTime, (int)readLe32(payload + 7),
+                                  getFloatFromBits(readLe32(payload + 11)), (PriorityLevel)payload[2]) != NULL;
+        }
+        
+        case JOURNAL_PROCESSED:
+        case JOURNAL_CONFIRMED:
+        case JOURNAL_CANCELLED: {
+            if (length != 17) {
+                return 0;
+            }
+            int reservationId = (int)readLe32(payload + 1);
+            int counterId = (int)readLe32(payload + 5);
+            IndexEntry* entry = findIndexEntry(&queue->index, reservationId);
+            replayTime = (time_t)readLe64(payload + 9);
+            if (entry == NULL) {
+                return 0;
+            }
+            
+            if (payload[0] == JOURNAL_CANCELLED && counterId == 0) {
+                if (entry->location != LOCATION_QUEUED) {
+                    return 0;
+                }
+                shedReservation(queue, entry->reservation);
+                return 1;
+            }
+            if (counterId < 1 || counterId > queue->counterCount) {
+                return 0;
+            }
+            
+            Counter* counter = &queue->counters[counterId - 1];
+            if (payload[0] == JOURNAL_PROCESSED) {
+                if (entry->location != LOCATION_QUEUED || counter->currentReservation != NULL) {
+                    return 0;
+                }
+                assignReservationToCounter(queue, entry->reservation, counter);
+            } else if (counter->currentReservation == NULL ||
+                       counter->currentReservation->reservationId != reservationId) {
+                return 0;
+            } else if (payload[0] == JOURNAL_CONFIRMED) {
+                confirmReservation(queue, counterId);
+            } else {
+                cancelReservation(queue, counterId);
+            }
+            return 1;
+        }
+        
+        case JOURNAL_TOTALS:
+            if (length != 25) {
+                return 0;
+            }
+            queue->nextReservationId = (int)readLe32(payload + 1);
+            queue->totalReservations = (int)readLe32(payload + 5);
+            queue->totalConfirmed = (int)readLe32(payload + 9);
+            queue->totalCancelled = (int)readLe32(payload + 13);
+            queue->totalShed = (int)readLe32(payload + 17);
+            queue->totalRevenue = getFloatFromBits(readLe32(payload + 21));
+            return 1;
+            
+        default:
+            return 0;
+    }
+}
+
+// Function to rebuild a reservation queue and its counters by replaying a
+// journal (NULL if the file is not a journal). Replay stops at the first
+// torn or corrupt record; stats->validBytes is where new records go
+// (0 when there is no journal yet).
+ReservationQueue* recoverReservationQueue(const char* path, JournalRecoveryStats* stats) {
+    memset(stats, 0, sizeof(*stats));
+    ReservationQueue* queue = createReservationQueue();
+    FILE* file = fopen(path, "rb");
+    if (file == NULL) {
+        return queue;
+    }
+    
+    unsigned char header[JOURNAL_HEADER_BYTES];
+    size_t headerBytes = fread(header, 1, sizeof(header), file);
+    if (headerBytes < sizeof(header)) {
+        // Crashed while creating the journal: nothing was committed yet
+        stats->discardedBytes = (long long)headerBytes;
+        fclose(file);
+        return queue;
+    }
+    if (readLe32(header) != JOURNAL_MAGIC || readLe32(header + 4) != JOURNAL_VERSION) {
+        printf("Error: '%s' is not a reservation journal\n", path);
+        fclose(file);
+        freeReservationQueue(queue);
+        return NULL;
+    }
+    
+    double begin = readWallSeconds();
+    unsigned char recordHeader[JOURNAL_RECORD_HEADER_BYTES], payload[JOURNAL_MAX_PAYLOAD];
+    stats->validBytes = JOURNAL_HEADER_BYTES;
+    reservationClock = readReplayClock;
+    quietMode = 1;
+    
+    while (fread(recordHeader, 1, sizeof(recordHeader), file) == sizeof(recordHeader)) {
+        size_t length = readLe32(recordHeader);
+        if (length == 0 || length > JOURNAL_MAX_PAYLOAD || fread(payload, 1, length, file) != length ||
+            getJournalChecksum(payload, length) != readLe32(recordHeader + 4)) {
+            break;
+        }
+        if (!replayJournalRecord(queue, payload, length)) {
+            stats->inconsistent++;
+        }
+        stats->records++;
+        stats->validBytes += JOURNAL_RECORD_HEADER_BYTES + (long long)length;
+    }
+    
+    reservationClock = NULL;
+    quietMode = 0;
+    stats->seconds = readWallSeconds() - begin;
+    fseek(file, 0, SEEK_END);
+    stats->discardedBytes = (long long)ftell(file) - stats->validBytes;
+    fclose(file);
+    return queue;
+}
+
+// Function to compare reservations by ID (qsort)
+int compareReservationIds(const void* a, const void* b) {
+    int first = (*(Reservation* const*)a)->reservationId;
+    int second = (*(Reservation* const*)b)->reservationId;
+    return (first > second) - (first < second);
+}
+
+// Function to start a journal with a snapshot of the current state: the
+// counters, every open reservation in ID order (replaying them in the order
+// they arrived rebuilds the same queue order), the ones at counters as
+// processed, and finally the totals
+void journalSnapshot(ReservationQueue* queue) {
+    int openCount = queue->size, used = 0;
+    for (int i = 0; i < queue->counterCount; i++) {
+        openCount += queue->counters[i].currentReservation != NULL;
+    }
+    
+    Reservation** open = (Reservation**)malloc((openCount > 0 ? openCount : 1) * sizeof(Reservation*));
+    for (Reservation* current = queue->front; current != NULL; current = current->next) {
+        open[used++] = current;
+    }
+    for (int i = 0; i < queue->counterCount; i++) {
+        if (queue->counters[i].currentReservation != NULL) {
+            open[used++] = queue->counters[i].currentReservation;
+        }
+    }
+    qsort(open, openCount, sizeof(Reservation*), compareReservationIds);
+    
+    for (int i = 0; i < queue->counterCount; i++) {
+        journalCounterAdded(queue->journal, &queue->counters[i]);
+    }
+    for (int i = 0; i < openCount; i++) {
+        journalReservationCreated(queue->journal, open[i]);
+    }
+    for (int i = 0; i < queue->counterCount; i++) {
+        Reservation* reservation = queue->counters[i].currentReservation;
+        if (reservation != NULL) {
+            journalReservationEvent(queue->journal, JOURNAL_PROCESSED, reservation->reservationId,
+                                    queue->counters[i].counterId, reservation->processTime);
+        }
+    }
+    journalTotals(queue->journal, queue);
+    commitJournal(queue->journal);
+    free(open);
 }
 
-// Function to confirm reservation
-void confirmReservation(ReservationQueue* queue, int counterId) {
-    if (counterId < 1 || counterId > queue->counterCount) {
-        printf("❌ Invalid counter ID!\n");
-        return;
+// Function to attach a journal to the system and return the queue to use
+// from now on. A journal with records replaces the current state with the
+// recovered one; a new or empty journal starts with a snapshot of it.
+ReservationQueue* attachReservationJournal(ReservationQueue* queue, const char* path, int groupCommitRecords) {
+    JournalRecoveryStats stats;
+    ReservationQueue* recovered = recoverReservationQueue(path, &stats);
+    if (recovered == NULL) {
+        return queue;
     }
     
-    Counter* counter = &queue->counters[counterId - 1];
-    
-    if (counter->currentReservation == NULL) {
-        printf("❌ No reservation being processed at counter %d!\n", counterId);
-        return;
+    if (stats.records > 0) {
+        // Capacity, overload policy and wait model are settings, not journaled state
+        recovered->capacity = queue->capacity;
+        recovered->overloadPolicy = queue->overloadPolicy;
+        recovered->blockTimeoutMinutes = queue->blockTimeoutMinutes;
+        recovered->useServiceRate = queue->useServiceRate;
+        refreshWaitTimes(recovered);
+        freeReservationQueue(queue);
+        queue = recovered;
+        
+        printf("🔁 Recovered %ld journal records in %.3f s: %d counters, %d waiting, next ID %d\n",
+               stats.records, stats.seconds, queue->counterCount, queue->size, queue->nextReservationId);
+        if (stats.inconsistent > 0) {
+            printf("   ⚠️  %ld records did not match the rebuilt state and were skipped\n", stats.inconsistent);
+        }
+    } else {
+        freeReservationQueue(recovered);
+    }
+    if (stats.discardedBytes > 0) {
+        printf("   Discarded a torn tail of %lld bytes\n", stats.discardedBytes);
     }
     
-    Reservation* reservation = counter->currentReservation;
-    reservation->status = TICKET_CONFIRMED;
-    reservation->confirmationTime = time(NULL);
-    
-    // Update statistics
-    queue->totalConfirmed++;
-    queue->totalRevenue += reservation->totalAmount;
-    counter->totalProcessed++;
-    
-    // Update average processing time
-    float processingTime = difftime(reservation->confirmationTime, reservation->processTime) / 60.0f;
-    counter->avgProcessingTime = ((counter->avgProcessingTime * (counter->totalProcessed - 1)) + processingTime) / counter->totalProcessed;
+    queue->journal = openReservationJournal(path, stats.validBytes, groupCommitRecords);
+    if (queue->journal == NULL) {
+        return queue;
+    }
+    if (stats.records == 0) {
+        journalSnapshot(queue);
+        printf("📝 Started journal '%s' with a snapshot of %d counters and %d waiting reservations\n",
+               path, queue->counterCount, queue->size);
+    } else {
+        printf("📝 Journaling to '%s'\n", path);
+    }
+    printf("   Group commit: one fsync per %d records (and after every menu action)\n", groupCommitRecords);
+    return queue;
+}
+
+// Function to run a journaled workload: reservations of every type and
+// priority arrive in bursts and the counters serve each burst, so every
+// reservation is created, processed and then confirmed or cancelled (one
+// in ten). The last partial burst is left in the queue and at the
+// counters. Returns the queue with its journal committed but still open.
+ReservationQueue* runJournaledWorkload(const char* path, long reservations, int groupCommitRecords,
+                                       double* seconds) {
+    static char* eventNames[RESERVATION_TYPES] = {"", "Evening Show", "Flight BA117", "Express 456",
+                                                   "Arena Concert", "Harbor Hotel"};
+    static char* locations[RESERVATION_TYPES] = {"", "Cinema City", "Terminal 5", "Central Station",
+                                                  "Madison Square Garden", "Downtown"};
+    ReservationQueue* queue = createReservationQueue();
+    char customerName[MAX_NAME_LENGTH];
+    unsigned int rngState = 20240201;
     
-    printf("✅ Reservation %d confirmed successfully!\n", reservation->reservationId);
-    printf("   Customer: %s\n", reservation->customerName);
-    printf("   Total Amount: $%.2f\n", reservation->totalAmount);
-    printf("   Processing Time: %.1f minutes\n", processingTime);
-    printf("   Total Wait Time: %.1f minutes\n", 
-           difftime(reservation->confirmationTime, reservation->requestTime) / 60.0f);
+    remove(path);
+    queue->journal = openReservationJournal(path, 0, groupCommitRecords);
+    if (queue->journal == NULL) {
+        freeReservationQueue(queue);
+        return NULL;
+    }
     
-    // Generate confirmation details
-    printf("\n--- TICKET CONFIRMATION ---\n");
-    printf("Confirmation Number: TKT%d\n", reservation->reservationId);
-    printf("Customer: %s\n", reservation->customerName);
-    printf("Email: %s\n", reservation->email);
-    printf("Phone: %s\n", reservation->phoneNumber);
-    printf("Event: %s\n", reservation->eventName);
-    printf("Location: %s\n", reservation->location);
-    printf("Date/Time: %s\n", reservation->dateTime);
-    printf("Number of Tickets: %d\n", reservation->numberOfTickets);
-    printf("Total Amount: $%.2f\n", reservation->totalAmount);
-    printf("Status: CONFIRMED\n");
-    printf("---------------------------\n");
+    quietMode = 1;
+    double begin = readWallSeconds();
+    addCounter(queue, "General Service", "Operator 1", 0);
+    for (int type = RESERVATION_MOVIE; type <= RESERVATION_HOTEL; type++) {
+        addCounter(queue, (char*)getReservationTypeString((ReservationType)type), "Operator", (ReservationType)type);
+    }
     
-    // Free the reservation and reset counter
-    free(reservation);
-    counter->currentReservation = NULL;
+    for (long i = 0; i < reservations; i++) {
+        ReservationType type = (ReservationType)(RESERVATION_MOVIE + nextRandom(&rngState) % 5);
+        snprintf(customerName, sizeof(customerName), "Customer %ld", i);
+        addReservation(queue, customerName, "customer@email.com", "555-0100", type, eventNames[type],
+                       locations[type], "2024-02-01 19:30", 1 + (int)(nextRandom(&rngState) % 4),
+                       (float)(20 + nextRandom(&rngState) % 200), pickSimulatedPriority(&rngState));
+        
+        if (queue->size < 3 * queue->counterCount || i + 1 == reservations) {
+            continue;
+        }
+        while (!isReservationQueueEmpty(queue)) {
+            for (int counterId = 1; counterId <= queue->counterCount; counterId++) {
+                if (queue->counters[counterId - 1].currentReservation != NULL) {
+                    if (nextRandom(&rngState) % 10 == 0) {
+                        cancelReservation(queue, counterId);
+                    } else {
+                        confirmReservation(queue, counterId);
+                    }
+                }
+                if (!isReservationQueueEmpty(queue)) {
+                    processNextReservation(queue, counterId);
+                }
+            }
+        }
+    }
     
-    printf("Counter %d is now available for next customer\n", counterId);
+    commitJournal(queue->journal);
+    *seconds = readWallSeconds() - begin;
+    quietMode = 0;
+    return queue;
 }
 
-// Function to cancel reservation
-void cancelReservation(ReservationQueue* queue, int counterId) {
-    if (counterId < 1 || counterId > queue->counterCount) {
-        printf("❌ Invalid counter ID!\n");
-        return;
+// Function to check that a recovered queue matches the original: the same
+// waiting reservations in the same order, the same counters and totals
+int compareRecoveredQueue(ReservationQueue* original, ReservationQueue* recovered) {
+    if (original->size != recovered->size || original->nextReservationId != recovered->nextReservationId ||
+        original->totalReservations != recovered->totalReservations ||
+        original->totalConfirmed != recovered->totalConfirmed ||
+        original->totalCancelled != recovered->totalCancelled || original->totalShed != recovered->totalShed ||
+        original->totalRevenue != recovered->totalRevenue || original->counterCount != recovered->counterCount) {
+        return 0;
     }
     
-    Counter* counter = &queue->counters[counterId - 1];
-    
-    if (counter->currentReservation == NULL) {
-        printf("❌ No reservation being processed at counter %d!\n", counterId);
-        return;
+    Reservation* first = original->front;
+    Reservation* second = recovered->front;
+    for (; first != NULL && second != NULL; first = first->next, second = second->next) {
+        if (first->reservationId != second->reservationId || first->requestTime != second->requestTime ||
+            first->details->totalAmount != second->details->totalAmount ||
+            strcmp(first->details->customerName, second->details->customerName) != 0) {
+            return 0;
+        }
+    }
+    if (first != NULL || second != NULL) {
+        return 0;
     }
     
-    Reservation* reservation = counter->currentReservation;
-    reservation->status = TICKET_CANCELLED;
-    
-    queue->totalCancelled++;
-    counter->totalProcessed++;
-    
-    printf("❌ Reservation %d cancelled\n", reservation->reservationId);
-    printf("   Customer: %s\n", reservation->customerName);
-    printf("   Reason: Customer request / Payment issue\n");
-    
-    // Free the reservation and reset counter
-    free(reservation);
-    counter->currentReservation = NULL;
-    
-    printf("Counter %d is now available for next customer\n", counterId);
+    for (int i = 0; i < original->counterCount; i++) {
+        Counter* a = &original->counters[i];
+        Counter* b = &recovered->counters[i];
+        int idA = a->currentReservation != NULL ? a->currentReservation->reservationId : 0;
+        int idB = b->currentReservation != NULL ? b->currentReservation->reservationId : 0;
+        if (idA != idB || a->totalProcessed != b->totalProcessed ||
+            a->avgProcessingTime != b->avgProcessingTime || strcmp(a->counterName, b->counterName) != 0) {
+            return 0;
+        }
+    }
+    return 1;
 }
 
-// Function to display queue status
-void displayQueueStatus(ReservationQueue* queue) {
-    printf("\n=== RESERVATION QUEUE STATUS ===\n");
-    printf("Reservations in queue: %d\n", queue->size);
-    printf("Next reservation ID: %d\n", queue->nextReservationId);
-    printf("Total reservations: %d\n", queue->totalReservations);
-    printf("Total confirmed: %d\n", queue->totalConfirmed);
-    printf("Total cancelled: %d\n", queue->totalCancelled);
-    printf("Total revenue: $%.2f\n", queue->totalRevenue);
-    printf("Success rate: %.1f%%\n", 
-           queue->totalReservations > 0 ? (float)queue->totalConfirmed / queue->totalReservations * 100 : 0);
+// Function to benchmark the journal: write throughput with a sync per
+// record (on a smaller run) and with the given group commit size, then the
+// time to recover the larger journal and a check of the rebuilt state
+void benchmarkReservationJournal(const char* path, long reservations, int groupCommitRecords) {
+    long syncEachCount = reservations < 5000 ? reservations : 5000;
     
-    if (isReservationQueueEmpty(queue)) {
-        printf("\nNo reservations waiting in queue\n");
-    } else {
-        printf("\nWaiting reservations:\n");
-        printf("%-6s %-20s %-8s %-25s %-8s %-10s %-8s\n", 
-               "ID", "Customer", "Type", "Event", "Tickets", "Amount", "Priority");
-        printf("-------------------------------------------------------------------------------------\n");
+    printf("\n=== JOURNAL BENCHMARK ===\n");
+    printf("%-7s %13s %11s %9s %9s %13s %9s %11s\n", "Group", "Reservations", "Records", "MB", "Seconds",
+           "Records/s", "Commits", "Commit us");
+    for (int run = 0; run < 2; run++) {
+        int group = run == 0 ? 1 : groupCommitRecords;
+        long count = run == 0 ? syncEachCount : reservations;
+        double seconds;
+        ReservationQueue* queue = runJournaledWorkload(path, count, group, &seconds);
+        if (queue == NULL) {
+            return;
+        }
         
-        Reservation* current = queue->front;
-        while (current != NULL) {
-            printf("%-6d %-20s %-8s %-25s %-8d $%-9.2f %-8s\n",
-                   current->reservationId,
-                   current->customerName,
-                   getReservationTypeString(current->type),
-                   current->eventName,
-                   current->numberOfTickets,
-                   current->totalAmount,
-                   getPriorityString(current->priority));
-            current = current->next;
+        ReservationJournal* journal = queue->journal;
+        printf("%-7d %13ld %11ld %9.1f %9.3f %13.0f %9ld %11.1f\n", group, count, journal->recordsWritten,
+               journal->bytesWritten / 1048576.0, seconds, journal->recordsWritten / seconds, journal->commits,
+               journal->commitSeconds * 1e6 / journal->commits);
+        if (run == 0) {
+            freeReservationQueue(queue);
+            continue;
         }
+        
+        closeReservationJournal(queue->journal);
+        queue->journal = NULL;
+        JournalRecoveryStats stats;
+        ReservationQueue* recovered = recoverReservationQueue(path, &stats);
+        if (recovered != NULL) {
+            printf("\nRecovery: %ld records (%.1f MB) in %.3f s, %.0f records/s\n", stats.records,
+                   stats.validBytes / 1048576.0, stats.seconds, stats.records / stats.seconds);
+            printf("Rebuilt %d counters and %d waiting reservations; state %s\n", recovered->counterCount,
+                   recovered->size, compareRecoveredQueue(queue, recovered) && stats.inconsistent == 0 ?
+                   "matches ✅" : "DIFFERS ❌");
+            freeReservationQueue(recovered);
+        }
+        freeReservationQueue(queue);
     }
-    printf("================================\n\n");
+    printf("Journal left at '%s'\n", path);
+    printf("=========================\n");
 }
 
-// Function to display counter status
-void displayCounterStatus(ReservationQueue* queue) {
-    if (queue->counterCount == 0) {
-        printf("No service counters configured!\n");
-        return;
-    }
+// Function to create a concurrent queue with one ring of ringSize slots
+// (a power of two) per priority level, whose intake threads block for up to
+// blockTimeoutSeconds on a full ring
+ConcurrentReservationQueue* createConcurrentReservationQueue(size_t ringSize, double blockTimeoutSeconds) {
+    ConcurrentReservationQueue* queue = (ConcurrentReservationQueue*)calloc(1, sizeof(ConcurrentReservationQueue));
     
-    printf("\n=== COUNTER STATUS ===\n");
-    printf("%-8s %-20s %-15s %-10s %-15s %-12s %-10s\n",
-           "Counter", "Name", "Operator", "Status", "Specialization", "Avg Time", "Processed");
-    printf("------------------------------------------------------------------------------------------------\n");
+    for (int level = 0; level < PRIORITY_LEVELS; level++) {
+        MpmcRing* ring = &queue->rings[level];
+        ring->cells = (MpmcCell*)malloc(ringSize * sizeof(MpmcCell));
+        ring->mask = ringSize - 1;
+        for (size_t i = 0; i < ringSize; i++) {
+            atomic_init(&ring->cells[i].sequence, i);
+            ring->cells[i].reservation = NULL;
+        }
+        atomic_init(&ring->enqueuePos, 0);
+        atomic_init(&ring->dequeuePos, 0);
+    }
+    atomic_init(&queue->nextReservationId, 1001);
+    queue->blockTimeoutSeconds = blockTimeoutSeconds;
+    return queue;
+}
+
+// Function to add to a ring from any thread (Vyukov's bounded MPMC queue).
+// A slot whose sequence equals the cursor is free for that turn; the
+// producer claims it with one CAS and publishes it by bumping the sequence.
+// Returns 0 if the ring is full.
+int mpmcEnqueue(MpmcRing* ring, Reservation* reservation) {
+    size_t position = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
     
-    for (int i = 0; i < queue->counterCount; i++) {
-        Counter* counter = &queue->counters[i];
-        char status[20], specialization[20];
+    for (;;) {
+        MpmcCell* cell = &ring->cells[position & ring->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)position;
         
-        if (!counter->isActive) {
-            strcpy(status, "Inactive");
-        } else if (counter->currentReservation == NULL) {
-            strcpy(status, "Available");
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->enqueuePos, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                cell->reservation = reservation;
+                atomic_store_explicit(&cell->sequence, position + 1, memory_order_release);
+                return 1;
+            }
+        } else if (difference < 0) {
+            return 0;
         } else {
-            sprintf(status, "Busy (ID:%d)", counter->currentReservation->reservationId);
+            position = atomic_load_explicit(&ring->enqueuePos, memory_order_relaxed);
         }
+    }
+}
+
+// Function to take the oldest reservation of a ring from any thread (NULL if
+// empty). Freeing the slot sets its sequence one lap ahead for the producers.
+Reservation* mpmcDequeue(MpmcRing* ring) {
+    size_t position = atomic_load_explicit(&ring->dequeuePos, memory_order_relaxed);
+    
+    for (;;) {
+        MpmcCell* cell = &ring->cells[position & ring->mask];
+        size_t sequence = atomic_load_explicit(&cell->sequence, memory_order_acquire);
+        intptr_t difference = (intptr_t)sequence - (intptr_t)(position + 1);
         
-        if (counter->specialization == 0) {
-            strcpy(specialization, "All Types");
+        if (difference == 0) {
+            if (atomic_compare_exchange_weak_explicit(&ring->dequeuePos, &position, position + 1,
+                                                      memory_order_relaxed, memory_order_relaxed)) {
+                Reservation* reservation = cell->reservation;
+                atomic_store_explicit(&cell->sequence, position + ring->mask + 1, memory_order_release);
+                return reservation;
+            }
+        } else if (difference < 0) {
+            return NULL;
         } else {
-            strcpy(specialization, getReservationTypeString(counter->specialization));
+            position = atomic_load_explicit(&ring->dequeuePos, memory_order_relaxed);
         }
-        
-        printf("%-8d %-20s %-15s %-10s %-15s %-12.1f %-10d\n",
-               counter->counterId,
-               counter->counterName,
-               counter->operatorName,
-               status,
-               specialization,
-               counter->avgProcessingTime,
-               counter->totalProcessed);
     }
-    printf("=====================\n\n");
 }
 
-// Function to search reservation by ID
-void searchReservation(ReservationQueue* queue, int reservationId) {
-    // Check in queue
-    Reservation* current = queue->front;
-    while (current != NULL) {
-        if (current->reservationId == reservationId) {
-            printf("\n=== RESERVATION FOUND (In Queue) ===\n");
-            printf("Reservation ID: %d\n", current->reservationId);
-            printf("Customer: %s\n", current->customerName);
-            printf("Email: %s\n", current->email);
-            printf("Phone: %s\n", current->phoneNumber);
-            printf("Type: %s\n", getReservationTypeString(current->type));
-            printf("Event: %s\n", current->eventName);
-            printf("Location: %s\n", current->location);
-            printf("Date/Time: %s\n", current->dateTime);
-            printf("Tickets: %d\n", current->numberOfTickets);
-            printf("Amount: $%.2f\n", current->totalAmount);
-            printf("Priority: %s\n", getPriorityString(current->priority));
-            printf("Status: %s\n", getTicketStatusString(current->status));
-            printf("Wait Time: %d minutes\n", current->estimatedWaitTime);
-            printf("===================================\n");
-            return;
+// Function to free a reservation created by an intake thread with its details
+void freeConcurrentReservation(Reservation* reservation) {
+    if (reservation != NULL) {
+        free(reservation->details);
+        free(reservation);
+    }
+}
+
+// Function to free a concurrent queue and any reservations left in it
+void freeConcurrentReservationQueue(ConcurrentReservationQueue* queue) {
+    Reservation* reservation;
+    for (int level = 0; level < PRIORITY_LEVELS; level++) {
+        while ((reservation = mpmcDequeue(&queue->rings[level])) != NULL) {
+            freeConcurrentReservation(reservation);
         }
-        current = current->next;
+        free(queue->rings[level].cells);
     }
+    free(queue);
+}
+
+// Function to create and queue a reservation from an intake thread and
+// return its ID (the reservation may be served and freed at once). A full
+// ring blocks the caller, yielding to the counter threads, until a slot
+// frees up; after blockTimeoutSeconds it gives up and returns 0. Intake
+// threads cannot share a side table, so each reservation gets its own details.
+int submitConcurrentReservation(ConcurrentReservationQueue* queue, char* customerName, ReservationType type,
+                                int numTickets, float amount, PriorityLevel priority) {
+    Reservation* reservation = (Reservation*)calloc(1, sizeof(Reservation));
+    ReservationDetails* details = (ReservationDetails*)calloc(1, sizeof(ReservationDetails));
+    int reservationId = atomic_fetch_add(&queue->nextReservationId, 1);
+    reservation->reservationId = reservationId;
+    strcpy(details->customerName, customerName);
+    details->numberOfTickets = numTickets;
+    details->totalAmount = amount;
+    reservation->details = details;
+    reservation->type = type;
+    reservation->priority = priority;
+    reservation->status = TICKET_PENDING;
+    reservation->requestTime = currentTime();
     
-    // Check at counters
-    for (int i = 0; i < queue->counterCount; i++) {
-        if (queue->counters[i].currentReservation != NULL &&
-            queue->counters[i].currentReservation->reservationId == reservationId) {
-            
-            Reservation* res = queue->counters[i].currentReservation;
-            printf("\n=== RESERVATION FOUND (Being Processed) ===\n");
-            printf("Reservation ID: %d\n", res->reservationId);
-            printf("Customer: %s\n", res->customerName);
-            printf("Current Status: Being processed at Counter %d\n", queue->counters[i].counterId);
-            printf("Operator: %s\n", queue->counters[i].operatorName);
-            printf("Processing Time: %.1f minutes\n", 
-                   difftime(time(NULL), res->processTime) / 60.0f);
-            printf("==========================================\n");
-            return;
+    double deadline = 0.0;
+    while (!mpmcEnqueue(&queue->rings[priority], reservation)) {
+        double now = readWallSeconds();
+        if (deadline == 0.0) {
+            deadline = now + queue->blockTimeoutSeconds;
+        } else if (now >= deadline) {
+            atomic_fetch_add_explicit(&queue->blockTimeouts, 1, memory_order_relaxed);
+            freeConcurrentReservation(reservation);
+            return 0;
+        }
+        atomic_fetch_add_explicit(&queue->fullRetries, 1, memory_order_relaxed);
+        sched_yield();
+    }
+    atomic_fetch_add_explicit(&queue->totalReservations, 1, memory_order_relaxed);
+    return reservationId;
+}
+
+// Function to take the next reservation for a counter thread: the oldest of
+// the highest non-empty priority (NULL if every ring is empty)
+Reservation* takeConcurrentReservation(ConcurrentReservationQueue* queue) {
+    for (int level = PRIORITY_EMERGENCY; level >= PRIORITY_NORMAL; level--) {
+        Reservation* reservation = mpmcDequeue(&queue->rings[level]);
+        if (reservation != NULL) {
+            reservation->processTime = currentTime();
+            return reservation;
         }
     }
+    return NULL;
+}
+
+// Function to confirm and free a reservation taken by a counter thread
+void confirmConcurrentReservation(ConcurrentReservationQueue* queue, Reservation* reservation) {
+    reservation->status = TICKET_CONFIRMED;
+    reservation->confirmationTime = currentTime();
+    atomic_fetch_add_explicit(&queue->totalConfirmed, 1, memory_order_relaxed);
+    atomic_fetch_add_explicit(&queue->revenueCents, llroundf(reservation->details->totalAmount * 100),
+                              memory_order_relaxed);
+    freeConcurrentReservation(reservation);
+}
+
+// Function run by each intake thread: submit its share with a mix of
+// priorities. Customers are named after the intake thread so the stress
+// test can check ordering; amounts are whole dollars so revenue is exact.
+void* intakeWorker(void* arg) {
+    ConcurrentWorker* worker = (ConcurrentWorker*)arg;
+    unsigned int rngState = worker->seed;
+    char customerName[MAX_NAME_LENGTH];
+    snprintf(customerName, sizeof(customerName), "Intake %d", worker->index);
     
-    printf("❌ Reservation ID %d not found!\n", reservationId);
+    for (int i = 0; i < worker->count; i++) {
+        PriorityLevel priority = pickSimulatedPriority(&rngState);
+        if (submitConcurrentReservation(worker->queue, customerName, (ReservationType)(RESERVATION_MOVIE + i % 5),
+                                        1, (float)(1 + i % 50), priority) != 0) {
+            worker->submittedCents += (long long)(1 + i % 50) * 100;
+        }
+    }
+    atomic_fetch_sub(worker->intakesRunning, 1);
+    return NULL;
 }
 
-// Function to setup sample data
-void setupSampleReservationData(ReservationQueue* queue) {
-    printf("Setting up sample reservation data...\n");
+// Function run by each counter thread: take and confirm reservations until
+// the intake threads are done and the rings are empty. With a check array it
+// records each id and verifies that ids from one intake thread and priority
+// arrive in order.
+void* counterWorker(void* arg) {
+    ConcurrentWorker* worker = (ConcurrentWorker*)arg;
+    ConcurrentReservationQueue* queue = worker->queue;
+    int* lastSeen = (int*)calloc((size_t)worker->intakeThreads * PRIORITY_LEVELS, sizeof(int));
     
-    // Add service counters
-    addCounter(queue, "Movie Tickets", "Alice Johnson", RESERVATION_MOVIE);
-    addCounter(queue, "Flight Booking", "Bob Smith", RESERVATION_FLIGHT);
-    addCounter(queue, "Train Reservations", "Carol Davis", RESERVATION_TRAIN);
-    addCounter(queue, "Event Tickets", "David Wilson", RESERVATION_EVENT);
-    addCounter(queue, "General Service", "Emma Brown", 0); // All types
+    for (;;) {
+        // Read before taking: empty rings after every intake finished mean nothing is left
+        int intakesDone = atomic_load(worker->intakesRunning) == 0;
+        Reservation* reservation = takeConcurrentReservation(queue);
+        if (reservation == NULL) {
+            if (intakesDone) {
+                break;
+            }
+            sched_yield();
+            continue;
+        }
+        
+        if (worker->seen != NULL) {
+            int id = reservation->reservationId;
+            int producer = 0;
+            sscanf(reservation->details->customerName, "Intake %d", &producer);
+            int* last = &lastSeen[producer * PRIORITY_LEVELS + reservation->priority];
+            if (atomic_fetch_add(&worker->seen[id - 1001], 1) != 0) {
+                worker->errors++;
+            }
+            if (id <= *last) {
+                worker->errors++;
+            }
+            *last = id;
+        }
+        confirmConcurrentReservation(queue, reservation);
+    }
     
-    // Add sample reservations
-    addReservation(queue, "John Doe", "john.doe@email.com", "555-0101",
-                  RESERVATION_MOVIE, "Avengers: Endgame", "Cinema City Mall", 
-                  "2024-01-15 19:30", 2, 24.50f, PRIORITY_NORMAL);
+    free(lastSeen);
+    return NULL;
+}
+
+// Function to run intake and counter threads over one queue; returns the
+// elapsed seconds. When seen is not NULL every reservation is checked.
+double runConcurrentWorkload(ConcurrentReservationQueue* queue, int intakeThreads, int counterThreads,
+                             int perIntake, atomic_int* seen, long* errors, long long* submittedCents) {
+    pthread_t* threads = (pthread_t*)malloc((intakeThreads + counterThreads) * sizeof(pthread_t));
+    ConcurrentWorker* workers = (ConcurrentWorker*)calloc(intakeThreads + counterThreads, sizeof(ConcurrentWorker));
+    atomic_int intakesRunning;
+    atomic_init(&intakesRunning, intakeThreads);
     
-    addReservation(queue, "Sarah Johnson", "sarah.j@email.com", "555-0102",
-                  RESERVATION_FLIGHT, "Flight AA123", "New York to London", 
-                  "2024-01-20 14:30", 1, 750.00f, PRIORITY_PREMIUM);
+    double begin = readWallSeconds();
+    for (int i = 0; i < intakeThreads + counterThreads; i++) {
+        workers[i].queue = queue;
+        workers[i].index = i;
+        workers[i].count = perIntake;
+        workers[i].intakeThreads = intakeThreads;
+        workers[i].intakesRunning = &intakesRunning;
+        workers[i].seen = seen;
+        workers[i].seed = 12345u + 7919u * (unsigned int)i;
+        pthread_create(&threads[i], NULL, i < intakeThreads ? intakeWorker : counterWorker, &workers[i]);
+    }
+    for (int i = 0; i < intakeThreads + counterThreads; i++) {
+        pthread_join(threads[i], NULL);
+    }
+    double seconds = readWallSeconds() - begin;
     
-    addReservation(queue, "Mike Chen", "mike.chen@email.com", "555-0103",
-                  RESERVATION_TRAIN, "Express Train 456", "Boston to Washington", 
-                  "2024-01-18 08:15", 2, 180.00f, PRIORITY_NORMAL);
+    *errors = 0;
+    *submittedCents = 0;
+    for (int i = 0; i < intakeThreads + counterThreads; i++) {
+        *errors += workers[i].errors;
+        *submittedCents += workers[i].submittedCents;
+    }
     
-    addReservation(queue, "Lisa Williams", "lisa.w@email.com", "555-0104",
-                  RESERVATION_EVENT, "Concert: Rock Legends", "Madison Square Garden", 
-                  "2024-01-25 20:00", 4, 320.00f, PRIORITY_VIP);
+    free(workers);
+    free(threads);
+    return seconds;
+}
+
+// Function to stress test the concurrent queue: every reservation must be
+// served exactly once unless its intake thread timed out blocking on a full
+// ring, in FIFO order per intake thread and priority, with exact totals;
+// then a single counter must drain a pre-filled queue in priority order
+void stressTestConcurrentQueue(int intakeThreads, int counterThreads, int perIntake, int blockTimeoutMs) {
+    long total = (long)intakeThreads * perIntake;
+    ConcurrentReservationQueue* queue = createConcurrentReservationQueue(MPMC_RING_SIZE, blockTimeoutMs / 1000.0);
+    atomic_int* seen = (atomic_int*)calloc(total, sizeof(atomic_int));
+    long errors, unserved = 0, duplicated = 0;
+    long long submittedCents;
     
-    addReservation(queue, "Emergency Travel", "urgent@email.com", "555-0105",
-                  RESERVATION_FLIGHT, "Emergency Flight", "Medical Emergency", 
-                  "2024-01-16 ASAP", 1, 1200.00f, PRIORITY_EMERGENCY);
+    printf("\n=== CONCURRENT QUEUE STRESS TEST ===\n");
+    printf("%d intake threads x %d reservations, %d counter threads, %d ms block timeout\n",
+           intakeThreads, perIntake, counterThreads, blockTimeoutMs);
+    double seconds = runConcurrentWorkload(queue, intakeThreads, counterThreads, perIntake, seen, &errors,
+                                           &submittedCents);
+    for (long i = 0; i < total; i++) {
+        int count = atomic_load(&seen[i]);
+        unserved += count == 0;
+        duplicated += count > 1;
+    }
     
-    addReservation(queue, "Robert Garcia", "rob.garcia@email.com", "555-0106",
-                  RESERVATION_HOTEL, "Grand Hotel Suite", "Downtown Manhattan", 
-                  "2024-01-22 Check-in", 1, 450.00f, PRIORITY_NORMAL);
+    // A submission that timed out is never served; anything else unserved was lost
+    long timedOut = atomic_load(&queue->blockTimeouts);
+    printf("Served %ld reservations in %.3f s\n", atomic_load(&queue->totalConfirmed), seconds);
+    printf("Timed out blocking on a full ring: %ld (%ld full-ring retries)\n", timedOut,
+           atomic_load(&queue->fullRetries));
+    printf("Lost or duplicated: %ld, out of order: %ld\n", unserved - timedOut + duplicated, errors);
+    printf("Revenue: $%.2f (expected $%.2f)\n", atomic_load(&queue->revenueCents) / 100.0, submittedCents / 100.0);
+    int passed = unserved == timedOut && duplicated == 0 && errors == 0 &&
+                 atomic_load(&queue->totalConfirmed) == total - timedOut &&
+                 atomic_load(&queue->revenueCents) == submittedCents;
+    freeConcurrentReservationQueue(queue);
+    free(seen);
     
-    printf("Sample reservation data setup complete!\n");
+    // Priority order: fill first, then drain with one counter
+    queue = createConcurrentReservationQueue(MPMC_RING_SIZE, blockTimeoutMs / 1000.0);
+    unsigned int rngState = 99;
+    int fill = perIntake < MPMC_RING_SIZE ? perIntake : MPMC_RING_SIZE;
+    for (int i = 0; i < fill; i++) {
+        submitConcurrentReservation(queue, "Priority Check", RESERVATION_EVENT, 1, 1.0f,
+                                    pickSimulatedPriority(&rngState));
+    }
+    Reservation* previous = NULL;
+    Reservation* reservation;
+    long orderErrors = 0;
+    while ((reservation = takeConcurrentReservation(queue)) != NULL) {
+        if (previous != NULL && (reservation->priority > previous->priority ||
+                                 (reservation->priority == previous->priority &&
+                                  reservation->reservationId < previous->reservationId))) {
+            orderErrors++;
+        }
+        freeConcurrentReservation(previous);
+        previous = reservation;
+    }
+    freeConcurrentReservation(previous);
+    freeConcurrentReservationQueue(queue);
+    
+    printf("Priority order check (%d queued, one counter): %ld violations\n", fill, orderErrors);
+    printf("Result: %s\n", passed && orderErrors == 0 ? "PASSED" : "FAILED");
+    printf("====================================\n");
 }
 
-// Function to free the reservation queue
-void freeReservationQueue(ReservationQueue* queue) {
-    while (!isReservationQueueEmpty(queue)) {
-        Reservation* reservation = queue->front;
-        queue->front = queue->front->next;
-        free(reservation);
-    }
+// Function to benchmark throughput with 1, 2, 4, ... intake threads and as
+// many counter threads
+void benchmarkConcurrentQueue(int maxThreads, int perIntake) {
+    double baseRate = 0.0;
     
-    // Free any reservations still being processed
-    for (int i = 0; i < queue->counterCount; i++) {
-        if (queue->counters[i].currentReservation != NULL) {
-            free(queue->counters[i].currentReservation);
+    printf("\n=== CONCURRENT QUEUE THROUGHPUT ===\n");
+    printf("%-8s %-8s %14s %14s %10s %12s %10s\n", "Intake", "Counters", "Reservations", "Per second", "Speedup",
+           "Full retries", "Timed out");
+    for (int threads = 1; threads <= maxThreads; threads *= 2) {
+        ConcurrentReservationQueue* queue = createConcurrentReservationQueue(MPMC_RING_SIZE,
+                                                                             CONCURRENT_BLOCK_TIMEOUT_MS / 1000.0);
+        long errors;
+        long long submittedCents;
+        double seconds = runConcurrentWorkload(queue, threads, threads, perIntake, NULL, &errors, &submittedCents);
+        double rate = (double)atomic_load(&queue->totalConfirmed) / seconds;
+        if (threads == 1) {
+            baseRate = rate;
         }
+        printf("%-8d %-8d %14ld %14.0f %9.2fx %12ld %10ld\n", threads, threads, atomic_load(&queue->totalConfirmed),
+               rate, rate / baseRate, atomic_load(&queue->fullRetries), atomic_load(&queue->blockTimeouts));
+        freeConcurrentReservationQueue(queue);
     }
-    
-    free(queue);
+    printf("===================================\n");
 }
 
 // Main function with menu-driven interface
@@ -626,7 +2674,7 @@ int main() {
     float amount;
     char name[MAX_NAME_LENGTH], email[MAX_NAME_LENGTH], phone[20];
     char eventName[MAX_EVENT_NAME], location[MAX_LOCATION_NAME], dateTime[30];
-    char counterName[MAX_NAME_LENGTH], operatorName[MAX_NAME_LENGTH];
+    char counterName[MAX_NAME_LENGTH], operatorName[MAX_NAME_LENGTH], traceFile[256];
     
     printf("🎫 Welcome to Reservation & Ticket Counter System! ✈️\n");
     printf("Efficient queue management for all your booking needs!\n\n");
@@ -644,7 +2692,16 @@ int main() {
         printf("9. Setup sample data\n");
         printf("10. Generate daily report\n");
         printf("11. Clear all data\n");
-        printf("12. Exit\n");
+        printf("12. Toggle wait-time model (flat / counter service rate)\n");
+        printf("13. Run load simulation (Poisson arrivals)\n");
+        printf("14. Run load simulation from arrival trace\n");
+        printf("15. Stress test concurrent queue (lock-free, multi-threaded)\n");
+        printf("16. Benchmark concurrent queue throughput\n");
+        printf("17. Configure queue capacity and overload policy\n");
+        printf("18. Open reservation journal (recover or start)\n");
+        printf("19. Close reservation journal\n");
+        printf("20. Benchmark journal write and recovery\n");
+        printf("21. Exit\n");
         printf("Enter your choice: ");
         
         scanf("%d", &choice);
@@ -771,19 +2828,189 @@ int main() {
                 break;
                 
             case 11:
+                if (reservationQueue->journal != NULL) {
+                    printf("Journal '%s' closed (clearing is not journaled)\n", reservationQueue->journal->path);
+                }
                 freeReservationQueue(reservationQueue);
                 reservationQueue = createReservationQueue();
                 printf("All data cleared!\n");
                 break;
                 
             case 12:
+                reservationQueue->useServiceRate = !reservationQueue->useServiceRate;
+                refreshWaitTimes(reservationQueue);
+                if (reservationQueue->useServiceRate) {
+                    printf("Wait estimates now use the counters' service rate (%.2f reservations/minute)\n",
+                           reservationQueue->serviceRate);
+                } else {
+                    printf("Wait estimates now use a flat %d minutes per reservation ahead\n",
+                           FLAT_MINUTES_PER_RESERVATION);
+                }
+                printf("Refreshed estimates for %d waiting reservations\n", reservationQueue->size);
+                break;
+                
+            case 13:
+            case 14:
+                if (reservationQueue->counterCount == 0) {
+                    printf("No service counters configured! Add counters or set up sample data first.\n");
+                    break;
+                }
+                {
+                    SimulationConfig config;
+                    SimArrival* arrivals = NULL;
+                    int arrivalCount = -1;
+                    
+                    if (choice == 13) {
+                        printf("Enter arrivals per minute, mean service minutes, duration in minutes and seed: ");
+                        scanf("%lf %lf %lf %u", &config.arrivalsPerMinute, &config.meanServiceMinutes,
+                              &config.durationMinutes, &config.seed);
+                        if (config.arrivalsPerMinute <= 0 || config.meanServiceMinutes <= 0 ||
+                            config.durationMinutes <= 0) {
+                            printf("Invalid simulation parameters!\n");
+                            break;
+                        }
+                    } else {
+                        printf("Enter trace file (lines of 'minute type priority'), mean service minutes and seed: ");
+                        scanf("%255s %lf %u", traceFile, &config.meanServiceMinutes, &config.seed);
+                        arrivalCount = loadArrivalTrace(traceFile, &arrivals);
+                        if (arrivalCount < 0 || config.meanServiceMinutes <= 0) {
+                            free(arrivals);
+                            break;
+                        }
+                        // The trace sets the arrivals, so it also sets the rate and duration
+                        config.durationMinutes = arrivalCount > 0 ? arrivals[arrivalCount - 1].seconds / 60.0 : 0.0;
+                        config.arrivalsPerMinute = config.durationMinutes > 0 ? arrivalCount / config.durationMinutes : 0.0;
+                    }
+                    
+                    SimulationResult result = runReservationSimulation(reservationQueue, &config, arrivals, arrivalCount);
+                    displaySimulationResult(reservationQueue, &result);
+                    freeSimulationResult(&result);
+                    free(arrivals);
+                }
+                break;
+                
+            case 15:
+                {
+                    int intakeThreads, counterThreads, perIntake, blockTimeoutMs;
+                    printf("Enter intake threads, counter threads, reservations per intake thread "
+                           "and full-ring block timeout in ms: ");
+                    scanf("%d %d %d %d", &intakeThreads, &counterThreads, &perIntake, &blockTimeoutMs);
+                    
+                    if (intakeThreads > 0 && counterThreads > 0 && perIntake > 0 && blockTimeoutMs > 0 &&
+                        (long)intakeThreads * perIntake <= 100000000L) {
+                        stressTestConcurrentQueue(intakeThreads, counterThreads, perIntake, blockTimeoutMs);
+                    } else {
+                        printf("Invalid stress test parameters!\n");
+                    }
+                }
+                break;
+                
+            case 16:
+                {
+                    int maxIntakeThreads, perIntake;
+                    printf("Enter max intake threads and reservations per intake thread: ");
+                    scanf("%d %d", &maxIntakeThreads, &perIntake);
+                    
+                    if (maxIntakeThreads > 0 && perIntake > 0 && (long)maxIntakeThreads * perIntake <= 100000000L) {
+                        benchmarkConcurrentQueue(maxIntakeThreads, perIntake);
+                    } else {
+                        printf("Invalid benchmark parameters!\n");
+                    }
+                }
+                break;
+                
+            case 17:
+                {
+                    int capacity, policy;
+                    double timeoutMinutes;
+                    printf("Enter queue capacity (0 for unbounded): ");
+                    scanf("%d", &capacity);
+                    printf("Overload policies: 1-Reject, 2-Shed lowest priority, 3-Block with timeout (simulations; the menu rejects)\n");
+                    printf("Enter overload policy (1-3): ");
+                    scanf("%d", &policy);
+                    
+                    if (capacity < 0 || policy < OVERLOAD_REJECT || policy > OVERLOAD_BLOCK) {
+                        printf("Invalid capacity or policy!\n");
+                        break;
+                    }
+                    if (policy == OVERLOAD_BLOCK) {
+                        printf("Enter block timeout in minutes: ");
+                        scanf("%lf", &timeoutMinutes);
+                        if (timeoutMinutes <= 0) {
+                            printf("Invalid timeout!\n");
+                            break;
+                        }
+                        reservationQueue->blockTimeoutMinutes = timeoutMinutes;
+                    }
+                    reservationQueue->capacity = capacity;
+                    reservationQueue->overloadPolicy = (OverloadPolicy)policy;
+                    if (capacity > 0) {
+                        printf("Queue capacity set to %d, when full: %s\n", capacity,
+                               getOverloadPolicyString(reservationQueue->overloadPolicy));
+                    } else {
+                        printf("Queue capacity is now unbounded\n");
+                    }
+                }
+                break;
+                
+            case 18:
+                if (reservationQueue->journal != NULL) {
+                    printf("Journal '%s' is already open!\n", reservationQueue->journal->path);
+                    break;
+                }
+                printf("Enter journal file path: ");
+                scanf("%255s", traceFile);
+                {
+                    int groupSize;
+                    printf("Enter records per group commit (1-%d, e.g. %d): ", MAX_GROUP_COMMIT, DEFAULT_GROUP_COMMIT);
+                    scanf("%d", &groupSize);
+                    if (groupSize < 1 || groupSize > MAX_GROUP_COMMIT) {
+                        printf("Invalid group size!\n");
+                        break;
+                    }
+                    reservationQueue = attachReservationJournal(reservationQueue, traceFile, groupSize);
+                }
+                break;
+                
+            case 19:
+                if (reservationQueue->journal == NULL) {
+                    printf("No journal is open!\n");
+                    break;
+                }
+                commitJournal(reservationQueue->journal);
+                printf("📝 Closed journal '%s': %ld records, %.1f KB in %ld commits%s\n",
+                       reservationQueue->journal->path, reservationQueue->journal->recordsWritten,
+                       reservationQueue->journal->bytesWritten / 1024.0, reservationQueue->journal->commits,
+                       reservationQueue->journal->broken ? " (stopped after a failed write)" : "");
+                closeReservationJournal(reservationQueue->journal);
+                reservationQueue->journal = NULL;
+                break;
+                
+            case 20:
+                printf("Enter journal file path, number of reservations and records per group commit: ");
+                {
+                    long reservations;
+                    int groupSize;
+                    if (scanf("%255s %ld %d", traceFile, &reservations, &groupSize) != 3 ||
+                        reservations < 1 || groupSize < 1 || groupSize > MAX_GROUP_COMMIT) {
+                        printf("Invalid benchmark parameters (group size 1-%d)!\n", MAX_GROUP_COMMIT);
+                        break;
+                    }
+                    benchmarkReservationJournal(traceFile, reservations, groupSize);
+                }
+                break;
+                
+            case 21:
                 printf("Thanks for using Reservation Management System!\n");
                 break;
                 
             default:
                 printf("Invalid choice! Please try again.\n");
         }
-    } while (choice != 12);
+        
+        // Everything an action journaled is durable before the next prompt
+        commitJournal(reservationQueue->journal);
+    } while (choice != 21);
     
     freeReservationQueue(reservationQueue);
     return 0;